@@ -0,0 +1,111 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ACIMMODEL_H
+#define ACIMMODEL_H
+
+#include <stdint.h>
+#include "my_fp.h"
+
+/** @brief Plant model of an induction motor with inverter for closed loop simulation
+ *
+ * Counterpart of PmsmModel with the same inputs and outputs. Stator current
+ * and rotor flux are integrated in the stationary frame, so the model works
+ * for U/f control with SineChannel as well as for FOC. GetFluxAngle() is the
+ * ideal field orientation angle, a real drive has to estimate it.
+ *
+ * Model: T equivalent circuit with magnetizing, stator and rotor leakage
+ * inductance, no saturation or iron losses. Mechanical equation as in
+ * PmsmModel.
+ */
+class AcimModel
+{
+   public:
+      AcimModel();
+
+      /** Set electrical parameters
+       * \param rs stator resistance in Ohm
+       * \param rr rotor resistance referred to the stator in Ohm
+       * \param lm magnetizing inductance in H
+       * \param lsl stator leakage inductance in H
+       * \param lrl rotor leakage inductance in H
+       * \param polePairs number of pole pairs
+       */
+      void SetElectricalParameters(float rs, float rr, float lm, float lsl, float lrl, int polePairs);
+
+      /** Set mechanical parameters
+       * \param inertia in kgm², 0 keeps the speed set with SetSpeed()
+       * \param friction viscous friction in Nm/(rad/s)
+       */
+      void SetMechanicalParameters(float inertia, float friction);
+
+      /** Set calling frequency of Step() in Hz and number of integration steps per call */
+      void SetCallingFrequency(int frequency, int subSteps);
+
+      /** Set PWM range that corresponds to the full DC link voltage, 65536 for FOC and SineCore */
+      void SetPwmRange(int32_t range) { pwmRange = range; }
+
+      void SetLoadTorque(float torque) { loadTorque = torque; }
+      void SetSpeed(float rpm);
+
+      /** Advance model by one control period
+       * \param dutyCycles duty cycles of the three phases, 0..pwm range
+       * \param udc DC link voltage
+       */
+      void Step(const int32_t* dutyCycles, s32fp udc);
+      void Step(const uint32_t* dutyCycles, s32fp udc) { Step((const int32_t*)dutyCycles, udc); }
+
+      /** Get phase currents in A, same scale as FOC::ParkClarke() expects */
+      s32fp GetIl1();
+      s32fp GetIl2();
+      /** Get electrical rotor angle, 0..65535 = 0..360° */
+      uint16_t GetAngle() { return (uint16_t)(int32_t)(angle * (65536.0f / TWO_PI)); }
+      /** Get angle of the rotor flux, 0..65535 = 0..360° */
+      uint16_t GetFluxAngle();
+      /** Get rotor flux magnitude in Vs */
+      float GetFlux();
+      /** Get mechanical speed in rpm */
+      float GetSpeed();
+      /** Get electrical rotor frequency in Hz */
+      float GetFrequency() { return omega / TWO_PI; }
+      float GetTorque() { return torque; }
+      /** Get stator current in rotor flux direction in A */
+      float GetId();
+      /** Get torque producing stator current in A */
+      float GetIq();
+      /** Get DC link current drawn from the supply in A */
+      float GetIdc() { return idc; }
+
+   private:
+      static const float TWO_PI;
+
+      float rs, rr, lm, ls, lr;
+      int polePairs;
+      float inertia, friction, loadTorque;
+      float dt;
+      int subSteps;
+      int32_t pwmRange;
+      float ialpha, ibeta; //!< stator current
+      float fluxAlpha, fluxBeta; //!< rotor flux
+      float angle; //!< electrical, 0..2pi
+      float omega; //!< electrical rad/s
+      float torque;
+      float idc;
+};
+
+#endif // ACIMMODEL_H
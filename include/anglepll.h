@@ -0,0 +1,87 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ANGLEPLL_H
+#define ANGLEPLL_H
+
+#include <stdint.h>
+#include "my_fp.h"
+
+/** @brief Tracking PLL for resolver and sin/cos encoder signals
+ *
+ * The angle error is sin(angle - estimate) = sin * cos(estimate) - cos * sin(estimate),
+ * which only needs two table lookups and two multiplications instead of Atan2().
+ * A PI controller turns the error into a speed that is integrated to the angle.
+ * The angle is kept with 16 additional fractional bits so slow speeds are tracked.
+ * Between samples Extrapolate() advances the angle by a fraction of the speed.
+ */
+class AnglePll
+{
+   public:
+      AnglePll();
+
+      /** Set loop gains
+       * \param kp proportional gain, angle error to speed
+       * \param ki integral gain, angle error to acceleration
+       * The error scales with the signal amplitude, so do the gains
+       */
+      void SetGains(int32_t kp, int32_t ki) { this->kp = kp; this->ki = ki; }
+
+      /** Set number of Extrapolate() calls between two Update() calls
+       * \param shift extrapolate 2^shift times per sample, 0 to disable
+       */
+      void SetExtrapolationShift(int shift) { extrapolationShift = shift; }
+
+      /** Process a new pair of samples
+       * \param sin sine signal, offset removed
+       * \param cos cosine signal, offset removed
+       * \return new angle estimate
+       */
+      uint16_t Update(int32_t sin, int32_t cos);
+
+      /** Advance angle estimate by the expected angle change until the next call
+       * \return extrapolated angle
+       */
+      uint16_t Extrapolate();
+
+      /** Get last angle estimate, 0..65535 = 0..360° */
+      uint16_t GetAngle() { return angle >> 16; }
+
+      /** Get speed in 1/65536 angle digits per Update() call */
+      int32_t GetSpeed() { return speed; }
+
+      /** Get frequency of the signal
+       * \param sampleFrequency calling frequency of Update() in Hz
+       * \return frequency in Hz
+       */
+      s32fp GetFrequency(int sampleFrequency);
+
+      /** Reset angle and speed, e.g. after losing the signal */
+      void Reset(uint16_t initialAngle);
+
+   private:
+      int32_t kp;
+      int32_t ki;
+      int extrapolationShift;
+      uint32_t angle; //!< 0..2^32 = 0..360°
+      uint32_t sampleAngle; //!< angle at last Update()
+      int32_t speed; //!< angle change per Update()
+      int32_t speedIntegral;
+};
+
+#endif // ANGLEPLL_H
@@ -19,7 +19,7 @@
 #ifndef DIGIO_H_INCLUDED
 #define DIGIO_H_INCLUDED
 
-#include <libopencm3/stm32/gpio.h>
+#include "hal_gpio.h"
 #include "digio_prj.h"
 
 namespace PinMode {
@@ -54,28 +54,28 @@ public:
    * @param[in] io pin index
    * @return pin value
    */
-   bool Get() { return gpio_get(_port, _pin) > 0; }
+   bool Get() { return hal_gpio_get(_port, _pin) > 0; }
 
    /**
    * Set pin high
    *
    * @param[in] io pin index
    */
-   void Set() { gpio_set(_port, _pin); }
+   void Set() { hal_gpio_set(_port, _pin); }
 
    /**
    * Set pin low
    *
    * @param[in] io pin index
    */
-   void Clear() { gpio_clear(_port, _pin); }
+   void Clear() { hal_gpio_clear(_port, _pin); }
 
    /**
    * Toggle pin
    *
    * @param[in] io pin index
    */
-   void Toggle() { gpio_toggle(_port, _pin); }
+   void Toggle() { hal_gpio_toggle(_port, _pin); }
 
 private:
    uint32_t _port;
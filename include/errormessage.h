@@ -22,7 +22,12 @@
 #include "errormessage_prj.h"
 #include <stdint.h>
 
+/* Besides ERROR_MESSAGE_ENTRY(id, type) the list may contain
+ * ERROR_EMCY_ENTRY(id, type, emcyCode) to send the error with a specific
+ * CiA 301 emergency error code, e.g. 0x2310 for continuous over current.
+ * Errors without a code are sent as 0x1000 generic error. */
 #define ERROR_MESSAGE_ENTRY(id, type) ERR_##id,
+#define ERROR_EMCY_ENTRY(id, type, emcyCode) ERR_##id,
 typedef enum
 {
    ERROR_NONE,
@@ -30,6 +35,7 @@ typedef enum
    ERROR_MESSAGE_LAST
 } ERROR_MESSAGE_NUM;
 #undef ERROR_MESSAGE_ENTRY
+#undef ERROR_EMCY_ENTRY
 
 typedef enum
 {
@@ -39,6 +45,8 @@ typedef enum
    ERROR_LAST
 } ERROR_TYPE;
 
+class Can;
+
 class ErrorMessage
 {
    public:
@@ -48,15 +56,24 @@ class ErrorMessage
       static void PrintAllErrors();
       static void PrintNewErrors();
       static ERROR_MESSAGE_NUM GetLastError();
+      static void SetCanInterface(Can* can, uint32_t minInterval);
    protected:
    private:
       static void PrintError(uint32_t time, ERROR_MESSAGE_NUM err);
+      static void SendEmcy(uint32_t time, ERROR_MESSAGE_NUM err);
 
       static uint32_t timeTick;
       static uint32_t currentBufIdx;
       static uint32_t lastPrintIdx;
       static bool posted[ERROR_MESSAGE_LAST];
       static ERROR_MESSAGE_NUM lastError;
+      static Can* emcyCan;
+      static uint32_t emcyInterval;
+      static uint32_t lastEmcyTime[ERROR_MESSAGE_LAST];
+      static uint32_t pendingEmcyTime[ERROR_MESSAGE_LAST];
+      static bool emcySent[ERROR_MESSAGE_LAST];
+      static bool emcyPending[ERROR_MESSAGE_LAST];
+      static volatile uint32_t pendingEmcyCount;
 };
 
 #endif // ERRORMESSAGE_H
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FIELDWEAKENING_H
+#define FIELDWEAKENING_H
+
+#include <stdint.h>
+#include "foc.h"
+#include "picontroller.h"
+
+/** @brief Current reference generation with MTPA and field weakening
+ *
+ * Below the voltage limit id and iq follow MTPA. When the voltage magnitude
+ * approaches the limit a PI controller drives id negative, iq is then
+ * limited to the remaining current circle.
+ *
+ * The voltage magnitude is compared in the squared domain and linearized
+ * around the limit: (limit² + |u|²) / (2 * limit) equals |u| at the limit
+ * and is never smaller elsewhere, so no square root is needed for the
+ * feedback. iq is the smaller of the MTPA q current and the current circle
+ * at the final id, both come from a single square root that is skipped
+ * when neither MTPA nor a limit is active. MTPA adds one more for its id.
+ */
+class FieldWeakening
+{
+   public:
+      FieldWeakening(FocChannel& foc);
+
+      /** Set PI gains of the voltage controller, see PiController::SetGains() */
+      void SetGains(int kp, int ki) { controller.SetGains(kp, ki); }
+
+      /** Set calling frequency of Run() in Hz */
+      void SetCallingFrequency(int frequency) { controller.SetCallingFrequency(frequency); }
+
+      /** Set voltage magnitude that is regulated to during field weakening
+       * \param maxMod modulation index, usually a few percent below FocChannel::GetMaximumModulationIndex()
+       * to leave headroom for the current controllers
+       */
+      void SetMaxModulation(int32_t maxMod);
+
+      /** Set current limits
+       * \param maxCurrent current circle radius, limits sqrt(id² + iq²)
+       * \param minId most negative d current for field weakening, limits demagnetization
+       */
+      void SetCurrentLimits(int32_t maxCurrent, int32_t minId);
+
+      /** Enable MTPA, requires FocChannel::SetMotorConstants() with Lq > Ld */
+      void SetMtpa(bool enable) { mtpa = enable; }
+
+      /** Calculate current references
+       * \param is requested current, sign sets the direction of torque
+       * \param ud d voltage of the last current controller run
+       * \param uq q voltage of the last current controller run
+       * \param[out] idref d current reference
+       * \param[out] iqref q current reference
+       */
+      void Run(int32_t is, int32_t ud, int32_t uq, int32_t& idref, int32_t& iqref);
+
+      /** Get d current demanded by the voltage controller, 0 when not field weakening */
+      int32_t GetFieldWeakeningCurrent() { return idfw; }
+
+      void ResetIntegrator() { controller.ResetIntegrator(); idfw = 0; }
+
+   private:
+      FocChannel& foc;
+      PiController controller;
+      int32_t maxModPow2;
+      uint32_t halfMaxModRecip; //!< 2^31 / maxMod
+      int32_t maxCurrent;
+      int32_t idfw;
+      bool mtpa;
+};
+
+#endif // FIELDWEAKENING_H
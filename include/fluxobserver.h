@@ -0,0 +1,96 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FLUXOBSERVER_H
+#define FLUXOBSERVER_H
+
+#include <stdint.h>
+#include "my_fp.h"
+#include "anglepll.h"
+
+/** @brief Sensorless rotor angle estimation for PMSM
+ *
+ * Nonlinear flux observer: the stator flux is integrated from
+ * u - R * i in the stationary frame, the rotor flux is stator flux - L * i.
+ * Integrator drift is removed by pulling the rotor flux magnitude towards
+ * the known flux linkage. The rotor flux vector is fed into an AnglePll
+ * that yields a smooth angle and speed.
+ *
+ * Execution time is constant: no loops, no divisions, four table lookups.
+ * As with all back-EMF based methods the angle is unusable near standstill.
+ */
+class FluxObserver
+{
+   public:
+      FluxObserver();
+
+      /** Set motor parameters
+       * \param resistance phase resistance in mOhm
+       * \param inductance phase inductance in µH (use (Ld + Lq) / 2 for IPM motors)
+       * \param fluxLinkage permanent magnet flux linkage in µVs
+       */
+      void SetMotorParameters(int32_t resistance, int32_t inductance, int32_t fluxLinkage);
+
+      /** Set calling frequency of Update() in Hz */
+      void SetCallingFrequency(int frequency);
+
+      /** Set rate at which flux drift is removed
+       * \param rate convergence rate in rad/s, e.g. 500
+       * @pre SetMotorParameters() and SetCallingFrequency() must be called first
+       */
+      void SetConvergenceRate(int32_t rate);
+
+      /** Set gains of the angle tracking PLL, see AnglePll::SetGains().
+       * The rotor flux is normalized to an amplitude of 2048 before it is passed to the PLL
+       */
+      void SetPllGains(int32_t kp, int32_t ki) { pll.SetGains(kp, ki); }
+
+      /** Run observer
+       * \param il1 phase 1 current, same scale as for FOC::ParkClarke()
+       * \param il2 phase 2 current
+       * \param ud d voltage modulation index that was output with FOC::InvParkClarke()
+       * \param uq q voltage modulation index
+       * \param angle angle that was used in FOC::InvParkClarke()
+       * \param udc DC link voltage
+       * \return estimated rotor angle
+       */
+      uint16_t Update(s32fp il1, s32fp il2, int32_t ud, int32_t uq, uint16_t angle, s32fp udc);
+
+      uint16_t GetAngle() { return pll.GetAngle(); }
+
+      /** Get electrical frequency in Hz */
+      s32fp GetFrequency() { return pll.GetFrequency(frequency); }
+
+      /** Reset flux estimate to the given angle */
+      void Reset(uint16_t angle);
+
+   private:
+      AnglePll pll;
+      int32_t fluxAlpha; //!< stator flux, 20 fractional bits
+      int32_t fluxBeta;
+      int32_t resistance; //!< Ohm, 16 fractional bits
+      int32_t inductance; //!< H, 24 fractional bits
+      int32_t fluxLinkage; //!< Vs, 20 fractional bits
+      int32_t fluxLinkagePow2;
+      int32_t dtFactor; //!< 1/frequency, 31 fractional bits
+      int32_t correctionGain;
+      int32_t pllScale;
+      int frequency;
+};
+
+#endif // FLUXOBSERVER_H
@@ -21,24 +21,72 @@
 
 #include <stdint.h>
 #include "my_fp.h"
+#include "sine_core.h"
 
-class FOC
+/** @brief Field oriented control transformations with per motor state
+ *
+ * One object per motor allows a single MCU to drive several motors.
+ * Output values come first so they share a cache line/load multiple,
+ * motor constants for MTPA follow.
+ */
+class FocChannel
 {
    public:
-      static void ParkClarke(s32fp il1, s32fp il2, uint16_t angle);
-      static int32_t GetQLimit(int32_t maxVd);
+      FocChannel();
+      void ParkClarke(s32fp il1, s32fp il2, uint16_t angle);
+      void InvParkClarke(int32_t ud, int32_t uq, uint16_t angle);
+      void Mtpa(int32_t is, int32_t& idref, int32_t& iqref);
+      int32_t MtpaId(int32_t is);
+      /** Set motor constants used for MTPA
+       * \param fluxLinkage permanent magnet flux linkage in Vs with 15 fractional digits
+       * \param lqminusld Lq - Ld in H with 15 fractional digits
+       */
+      void SetMotorConstants(s32fp fluxLinkage, s32fp lqminusld);
+      void SetPwmMode(PwmMode::PwmMode mode) { pwmMode = mode; }
+      /** Allow voltage vectors beyond the linear range up to six-step operation */
+      void SetOvermodulation(bool enable) { overmodulation = enable; }
+      void SetDeadTimeCompensation(int32_t comp, s32fp band);
+      int32_t GetQLimit(int32_t maxVd);
       static int32_t GetTotalVoltage(int32_t ud, int32_t uq);
-      static void InvParkClarke(int32_t ud, int32_t uq, uint16_t angle);
-      static void Mtpa(int32_t is, int32_t& idref, int32_t& iqref);
-      static int32_t GetMaximumModulationIndex();
-      static s32fp id;
-      static s32fp iq;
-      static int32_t DutyCycles[3];
-
-   protected:
-   private:
+      int32_t GetMaximumModulationIndex();
+      /** Integer square root by Newton iteration, result may be one above the exact root */
       static uint32_t sqrt(uint32_t rad);
+      /** Square root of a fixed point value with 15 fractional digits */
       static u32fp fpsqrt(u32fp rad);
+      s32fp id;
+      s32fp iq;
+      int32_t DutyCycles[3];
+
+   private:
+      void Overmodulate(uint32_t magnitudePow2);
+
+      s32fp fluxLinkage;
+      s32fp fluxLinkage2;
+      s32fp lqminusld;
+      s32fp lqminusldSquaredBs10;
+      PwmMode::PwmMode pwmMode;
+      bool overmodulation;
+      s32fp dtBand;
+      int32_t dtGain;
+};
+
+/** @brief Static interface to the FocChannel of the first motor */
+class FOC
+{
+   public:
+      static void ParkClarke(s32fp il1, s32fp il2, uint16_t angle) { defaultChannel.ParkClarke(il1, il2, angle); }
+      static int32_t GetQLimit(int32_t maxVd) { return defaultChannel.GetQLimit(maxVd); }
+      static int32_t GetTotalVoltage(int32_t ud, int32_t uq) { return FocChannel::GetTotalVoltage(ud, uq); }
+      static void InvParkClarke(int32_t ud, int32_t uq, uint16_t angle) { defaultChannel.InvParkClarke(ud, uq, angle); }
+      static void Mtpa(int32_t is, int32_t& idref, int32_t& iqref) { defaultChannel.Mtpa(is, idref, iqref); }
+      static int32_t GetMaximumModulationIndex() { return defaultChannel.GetMaximumModulationIndex(); }
+      static void SetPwmMode(PwmMode::PwmMode mode) { defaultChannel.SetPwmMode(mode); }
+      static void SetOvermodulation(bool enable) { defaultChannel.SetOvermodulation(enable); }
+      static void SetDeadTimeCompensation(int32_t comp, s32fp band) { defaultChannel.SetDeadTimeCompensation(comp, band); }
+      static FocChannel defaultChannel;
+      static s32fp& id;
+      static s32fp& iq;
+      static int32_t (&DutyCycles)[3];
 };
 
 #endif // FOC_H
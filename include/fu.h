@@ -25,19 +25,29 @@
 class MotorVoltage
 {
 public:
+   static const int MAX_POINTS = 16;
+
    static void SetBoost(uint32_t boost);
    static void SetWeakeningFrq(u32fp frq);
    static void SetMaxAmp(uint32_t maxAmp);
+   static void SetCurve(const u32fp* frq, const uint32_t* amp, int numPoints);
    static uint32_t GetAmp(u32fp frq);
    static uint32_t GetAmpPerc(u32fp frq, u32fp perc);
 
 private:
+   static const int64_t PERC_RECIP = 1342177; //!< 2^32 / (100 * FRAC_FAC), rounded down
+
    static void CalcFac();
+   static void CalcSegments(const u32fp* frq, const uint32_t* amp, int numPoints);
+   static int32_t CalcAmp(u32fp frq);
    static uint32_t boost;
-   static u32fp fac;
    static uint32_t maxAmp;
    static u32fp endFrq;
-   static u32fp maxFrq;
+   static bool userCurve;
+   static int numSegments;
+   static u32fp segFrq[MAX_POINTS]; //!< start frequency of segment
+   static int32_t segAmp[MAX_POINTS]; //!< amplitude at start frequency
+   static int32_t segSlope[MAX_POINTS]; //!< slope in digit/Hz, fixed point
 };
 
 #endif // FU_H_INCLUDED
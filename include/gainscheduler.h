@@ -0,0 +1,88 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GAINSCHEDULER_H
+#define GAINSCHEDULER_H
+
+#include "params.h"
+#include "picontroller.h"
+
+/** @brief Interpolates PI gains from a 1D or 2D breakpoint table
+ *
+ * The table lives in consecutive parameters so it can be edited via terminal
+ * or SDO and is saved with all other parameters:
+ * - numX breakpoints of the first input, strictly increasing
+ * - numY breakpoints of the second input, strictly increasing (none for 1D)
+ * - numX * numY kp values, x index running fastest
+ * - numX * numY ki values, x index running fastest
+ *
+ * LoadFromParams() copies the table and precomputes the reciprocal breakpoint
+ * distances, it must be called whenever a table parameter changes, e.g. from
+ * parm_Change(). Apply() then only needs a search, multiplications and shifts.
+ *
+ * Apply() only supports PiController. Other controllers can be fed from
+ * GetGains(), taking care that their Run() does not see a mixed set.
+ */
+class GainScheduler
+{
+   public:
+      static const int MAX_POINTS = 8;
+
+      /** Construct a gain scheduler
+       * \param firstParam first parameter of the table, i.e. first x breakpoint
+       * \param numX number of x breakpoints, 2..MAX_POINTS
+       * \param numY number of y breakpoints, 1 for a 1D table, 1..MAX_POINTS
+       * Out of range counts are clamped to the nearest allowed value.
+       */
+      GainScheduler(Param::PARAM_NUM firstParam, int numX, int numY = 1);
+
+      /** Copy table from parameters and precompute interpolation factors */
+      void LoadFromParams();
+
+      /** Interpolate gains at the given operating point
+       * \param x first input, e.g. speed
+       * \param y second input, e.g. DC link voltage. Ignored for 1D tables
+       * \param[out] kp interpolated proportional gain
+       * \param[out] ki interpolated integral gain
+       */
+      void GetGains(s32fp x, s32fp y, int& kp, int& ki);
+
+      /** Interpolate gains and set them on the given controller.
+       * Interrupts are masked while both gains are stored, so a Run() call
+       * from an interrupt never sees a mixed set */
+      void Apply(PiController& ctrl, s32fp x, s32fp y = 0);
+
+   private:
+      /** Fractional bits of interpolation factor */
+      static const int FRAC_BITS = 16;
+
+      static int FindSegment(const s32fp* points, const int32_t* invDist, int num, s32fp val, int32_t& frac);
+      static int Interpolate(int a, int b, int32_t frac);
+
+      Param::PARAM_NUM firstParam;
+      int numX;
+      int numY;
+      s32fp xPoints[MAX_POINTS];
+      s32fp yPoints[MAX_POINTS];
+      int32_t xInvDist[MAX_POINTS - 1]; //!< 2^30 / (x[i + 1] - x[i])
+      int32_t yInvDist[MAX_POINTS - 1]; //!< 2^30 / (y[i + 1] - y[i])
+      int32_t kpTable[MAX_POINTS * MAX_POINTS];
+      int32_t kiTable[MAX_POINTS * MAX_POINTS];
+};
+
+#endif // GAINSCHEDULER_H
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_ADC_H_INCLUDED
+#define HAL_ADC_H_INCLUDED
+
+/** @brief ADC1 in continuous scan mode, results are written to a circular
+ * buffer by DMA
+ *
+ * On the target hal_adc_start() is the libopencm3 sequence AnaIn used to
+ * run directly. With HOST_BUILD hal_adc_host.cpp plays the DMA, the
+ * simulation sets channel values and triggers conversions.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#define ADC_SMPR_SMP_1DOT5CYC   0
+#define ADC_SMPR_SMP_7DOT5CYC   1
+#define ADC_SMPR_SMP_13DOT5CYC  2
+#define ADC_SMPR_SMP_28DOT5CYC  3
+#define ADC_SMPR_SMP_41DOT5CYC  4
+#define ADC_SMPR_SMP_55DOT5CYC  5
+#define ADC_SMPR_SMP_71DOT5CYC  6
+#define ADC_SMPR_SMP_239DOT5CYC 7
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_adc_start(uint8_t* channels, int numChannels, uint16_t* buffer, int bufferSize, uint8_t sampleTime);
+
+/* Simulation interface */
+void hal_adc_host_set(int channel, uint16_t value);
+void hal_adc_host_convert(int sequences);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/adc.h>
+#include <libopencm3/stm32/dma.h>
+
+#define HAL_ADC_DMA_CHAN 1
+
+static inline void hal_adc_start(uint8_t* channels, int numChannels, uint16_t* buffer, int bufferSize, uint8_t sampleTime)
+{
+   adc_power_off(ADC1);
+   adc_enable_scan_mode(ADC1);
+   adc_set_continuous_conversion_mode(ADC1);
+   adc_set_right_aligned(ADC1);
+   adc_set_sample_time_on_all_channels(ADC1, sampleTime);
+
+   adc_power_on(ADC1);
+   /* wait for adc starting up*/
+   for (volatile int i = 0; i < 80000; i++);
+
+   adc_reset_calibration(ADC1);
+   adc_calibrate(ADC1);
+
+   adc_set_regular_sequence(ADC1, numChannels, channels);
+   adc_enable_dma(ADC1);
+
+   dma_set_peripheral_address(DMA1, HAL_ADC_DMA_CHAN, (uint32_t)&ADC_DR(ADC1));
+   dma_set_memory_address(DMA1, HAL_ADC_DMA_CHAN, (uint32_t)buffer);
+   dma_set_peripheral_size(DMA1, HAL_ADC_DMA_CHAN, DMA_CCR_PSIZE_16BIT);
+   dma_set_memory_size(DMA1, HAL_ADC_DMA_CHAN, DMA_CCR_MSIZE_16BIT);
+   dma_set_number_of_data(DMA1, HAL_ADC_DMA_CHAN, bufferSize);
+   dma_enable_memory_increment_mode(DMA1, HAL_ADC_DMA_CHAN);
+   dma_enable_circular_mode(DMA1, HAL_ADC_DMA_CHAN);
+   dma_enable_channel(DMA1, HAL_ADC_DMA_CHAN);
+
+   adc_start_conversion_regular(ADC1);
+   adc_start_conversion_direct(ADC1);
+}
+
+#endif // HOST_BUILD
+
+#endif // HAL_ADC_H_INCLUDED
@@ -0,0 +1,196 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_CAN_H_INCLUDED
+#define HAL_CAN_H_INCLUDED
+
+/** @brief bxCAN access for the Can class
+ *
+ * Message data is passed as two 32 bit words like everywhere in Can.
+ * On the target these are inline wrappers of libopencm3. With HOST_BUILD
+ * hal_can_host.cpp simulates three transmit mailboxes, two three deep
+ * receive FIFOs and the 16 bit ID list filters, the simulation plays the bus.
+ */
+
+#include <stdint.h>
+
+#define HAL_CAN_FILTERS_PER_BANK 4
+
+#ifdef HOST_BUILD
+
+#define CAN1 0x40006400
+#define CAN2 0x40006800
+
+#define CAN_BTR_TS1_1TQ  (0 << 16)
+#define CAN_BTR_TS1_2TQ  (1 << 16)
+#define CAN_BTR_TS1_3TQ  (2 << 16)
+#define CAN_BTR_TS1_4TQ  (3 << 16)
+#define CAN_BTR_TS1_5TQ  (4 << 16)
+#define CAN_BTR_TS1_6TQ  (5 << 16)
+#define CAN_BTR_TS1_7TQ  (6 << 16)
+#define CAN_BTR_TS1_8TQ  (7 << 16)
+#define CAN_BTR_TS1_9TQ  (8 << 16)
+#define CAN_BTR_TS1_10TQ (9 << 16)
+#define CAN_BTR_TS2_1TQ  (0 << 20)
+#define CAN_BTR_TS2_2TQ  (1 << 20)
+#define CAN_BTR_TS2_3TQ  (2 << 20)
+#define CAN_BTR_TS2_4TQ  (3 << 20)
+#define CAN_BTR_TS2_5TQ  (4 << 20)
+#define CAN_BTR_TS2_6TQ  (5 << 20)
+#define CAN_BTR_TS2_7TQ  (6 << 20)
+#define CAN_BTR_TS2_8TQ  (7 << 20)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_can_setup_pins(uint32_t can);
+void hal_can_reset(uint32_t can);
+void hal_can_init(uint32_t can, uint32_t ts1, uint32_t ts2, uint32_t prescaler);
+void hal_can_enable_rx_irq(uint32_t can);
+void hal_can_enable_tx_irq(uint32_t can, bool enable);
+int hal_can_transmit(uint32_t can, uint32_t id, uint8_t len, const uint32_t data[2]);
+int hal_can_receive(uint32_t can, int fifo, uint32_t* id, uint8_t* len, uint32_t data[2]);
+void hal_can_filter_id_list(int filterId, const uint16_t ids[HAL_CAN_FILTERS_PER_BANK], int fifo);
+int hal_can_first_filter(uint32_t can);
+
+/* Simulation interface */
+int hal_can_host_pending(uint32_t can);
+bool hal_can_host_transmit_complete(uint32_t can, uint32_t* id, uint8_t* len, uint32_t data[2]);
+bool hal_can_host_receive(uint32_t can, uint32_t id, uint8_t len, const uint32_t data[2]);
+bool hal_can_host_tx_irq_enabled(uint32_t can);
+int hal_can_host_rx_pending(uint32_t can, int fifo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/can.h>
+#include <libopencm3/stm32/gpio.h>
+#include <libopencm3/cm3/nvic.h>
+
+/** Configure the non-remapped pins and enable the interrupts at lowest priority */
+static inline void hal_can_setup_pins(uint32_t can)
+{
+   if (can == CAN1)
+   {
+      // Configure CAN pin: RX (input pull-up).
+      gpio_set_mode(GPIO_BANK_CAN1_RX, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_CAN1_RX);
+      gpio_set(GPIO_BANK_CAN1_RX, GPIO_CAN1_RX);
+      // Configure CAN pin: TX.-
+      gpio_set_mode(GPIO_BANK_CAN1_TX, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_CAN1_TX);
+      //CAN1 RX and TX IRQs
+      nvic_enable_irq(NVIC_USB_LP_CAN_RX0_IRQ); //CAN RX
+      nvic_set_priority(NVIC_USB_LP_CAN_RX0_IRQ, 0xf << 4); //lowest priority
+      nvic_enable_irq(NVIC_CAN_RX1_IRQ); //CAN RX
+      nvic_set_priority(NVIC_CAN_RX1_IRQ, 0xf << 4); //lowest priority
+      nvic_enable_irq(NVIC_USB_HP_CAN_TX_IRQ); //CAN TX
+      nvic_set_priority(NVIC_USB_HP_CAN_TX_IRQ, 0xf << 4); //lowest priority
+   }
+   else if (can == CAN2)
+   {
+      // Configure CAN pin: RX (input pull-up).
+      gpio_set_mode(GPIO_BANK_CAN2_RX, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_CAN2_RX);
+      gpio_set(GPIO_BANK_CAN2_RX, GPIO_CAN2_RX);
+      // Configure CAN pin: TX.-
+      gpio_set_mode(GPIO_BANK_CAN2_TX, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_CAN2_TX);
+
+      //CAN2 RX and TX IRQs
+      nvic_enable_irq(NVIC_CAN2_RX0_IRQ); //CAN RX
+      nvic_set_priority(NVIC_CAN2_RX0_IRQ, 0xf << 4); //lowest priority
+      nvic_enable_irq(NVIC_CAN2_RX1_IRQ); //CAN RX
+      nvic_set_priority(NVIC_CAN2_RX1_IRQ, 0xf << 4); //lowest priority
+      nvic_enable_irq(NVIC_CAN2_TX_IRQ); //CAN RX
+      nvic_set_priority(NVIC_CAN2_TX_IRQ, 0xf << 4); //lowest priority
+   }
+}
+
+static inline void hal_can_reset(uint32_t can) { can_reset(can); }
+
+static inline void hal_can_init(uint32_t can, uint32_t ts1, uint32_t ts2, uint32_t prescaler)
+{
+   can_init(can,
+            false,          // TTCM: Time triggered comm mode?
+            true,           // ABOM: Automatic bus-off management?
+            false,          // AWUM: Automatic wakeup mode?
+            false,          // NART: No automatic retransmission?
+            false,          // RFLM: Receive FIFO locked mode?
+            false,          // TXFP: Transmit FIFO priority?
+            CAN_BTR_SJW_1TQ,
+            ts1,
+            ts2,
+            prescaler,      // BRP+1: Baud rate prescaler
+            false,
+            false);
+}
+
+static inline void hal_can_enable_rx_irq(uint32_t can)
+{
+   can_enable_irq(can, CAN_IER_FMPIE0);
+   can_enable_irq(can, CAN_IER_FMPIE1);
+}
+
+static inline void hal_can_enable_tx_irq(uint32_t can, bool enable)
+{
+   if (enable)
+      can_enable_irq(can, CAN_IER_TMEIE);
+   else
+      can_disable_irq(can, CAN_IER_TMEIE);
+}
+
+/** @return mailbox number or -1 if all mailboxes are busy */
+static inline int hal_can_transmit(uint32_t can, uint32_t id, uint8_t len, const uint32_t data[2])
+{
+   return can_transmit(can, id, false, false, len, (uint8_t*)data);
+}
+
+/** Read and release one message from fifo
+ * @return > 0 if a message was read */
+static inline int hal_can_receive(uint32_t can, int fifo, uint32_t* id, uint8_t* len, uint32_t data[2])
+{
+   bool ext, rtr;
+   uint8_t fmi;
+
+   return can_receive(can, fifo, true, id, &ext, &rtr, &fmi, len, (uint8_t*)data, NULL);
+}
+
+/** Accept the four standard IDs of ids into fifo */
+static inline void hal_can_filter_id_list(int filterId, const uint16_t ids[HAL_CAN_FILTERS_PER_BANK], int fifo)
+{
+   can_filter_id_list_16bit_init(
+         filterId,
+         ids[0] << 5, //left align
+         ids[1] << 5,
+         ids[2] << 5,
+         ids[3] << 5,
+         fifo,
+         true);
+}
+
+/** @return first filter bank of the given interface */
+static inline int hal_can_first_filter(uint32_t can)
+{
+   return can == CAN1 ? 0 : ((CAN_FMR(CAN2) >> 8) & 0x3F);
+}
+
+#endif // HOST_BUILD
+
+#endif // HAL_CAN_H_INCLUDED
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_FLASH_H_INCLUDED
+#define HAL_FLASH_H_INCLUDED
+
+/** @brief Flash and CRC unit access for persistent storage
+ *
+ * On the target these are inline wrappers of libopencm3, so the generated
+ * code does not change. With HOST_BUILD defined they are implemented by
+ * hal_flash_host.cpp: flash is simulated in RAM at the same addresses,
+ * the CRC is calculated in software with the algorithm of the STM32 CRC unit.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#ifndef HOST_FLASH_BASE
+#define HOST_FLASH_BASE      0x08000000
+#endif
+#ifndef HOST_FLASH_SIZE
+#define HOST_FLASH_SIZE      (128 * 1024)
+#endif
+#ifndef HOST_FLASH_PAGE_SIZE
+#define HOST_FLASH_PAGE_SIZE 1024
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_flash_unlock(void);
+void hal_flash_lock(void);
+void hal_flash_set_ws(uint32_t waitStates);
+void hal_flash_erase_page(uint32_t address);
+void hal_flash_program_word(uint32_t address, uint32_t data);
+const uint32_t* hal_flash_pointer(uint32_t address);
+void hal_crc_reset(void);
+uint32_t hal_crc_calculate(uint32_t data);
+uint32_t hal_crc_calculate_block(const uint32_t* data, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/flash.h>
+#include <libopencm3/stm32/crc.h>
+
+static inline void hal_flash_unlock(void) { flash_unlock(); }
+static inline void hal_flash_lock(void) { flash_lock(); }
+static inline void hal_flash_set_ws(uint32_t waitStates) { flash_set_ws(waitStates); }
+static inline void hal_flash_erase_page(uint32_t address) { flash_erase_page(address); }
+static inline void hal_flash_program_word(uint32_t address, uint32_t data) { flash_program_word(address, data); }
+static inline const uint32_t* hal_flash_pointer(uint32_t address) { return (const uint32_t*)address; }
+static inline void hal_crc_reset(void) { crc_reset(); }
+static inline uint32_t hal_crc_calculate(uint32_t data) { return crc_calculate(data); }
+static inline uint32_t hal_crc_calculate_block(const uint32_t* data, int size) { return crc_calculate_block((uint32_t*)data, size); }
+
+#endif // HOST_BUILD
+
+#endif // HAL_FLASH_H_INCLUDED
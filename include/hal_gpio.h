@@ -0,0 +1,115 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_GPIO_H_INCLUDED
+#define HAL_GPIO_H_INCLUDED
+
+/** @brief GPIO access
+ *
+ * On the target these are inline wrappers of libopencm3. With HOST_BUILD
+ * the port and pin constants of libopencm3 are provided here, so the
+ * project headers (digio_prj.h, anain_prj.h) compile unchanged, and
+ * hal_gpio_host.cpp keeps simulated port registers.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#define GPIOA 0x40010800
+#define GPIOB 0x40010C00
+#define GPIOC 0x40011000
+#define GPIOD 0x40011400
+#define GPIOE 0x40011800
+
+#define GPIO0  (1 << 0)
+#define GPIO1  (1 << 1)
+#define GPIO2  (1 << 2)
+#define GPIO3  (1 << 3)
+#define GPIO4  (1 << 4)
+#define GPIO5  (1 << 5)
+#define GPIO6  (1 << 6)
+#define GPIO7  (1 << 7)
+#define GPIO8  (1 << 8)
+#define GPIO9  (1 << 9)
+#define GPIO10 (1 << 10)
+#define GPIO11 (1 << 11)
+#define GPIO12 (1 << 12)
+#define GPIO13 (1 << 13)
+#define GPIO14 (1 << 14)
+#define GPIO15 (1 << 15)
+
+#define GPIO_MODE_INPUT                0
+#define GPIO_MODE_OUTPUT_10_MHZ        1
+#define GPIO_MODE_OUTPUT_2_MHZ         2
+#define GPIO_MODE_OUTPUT_50_MHZ        3
+#define GPIO_CNF_INPUT_ANALOG          0
+#define GPIO_CNF_INPUT_FLOAT           1
+#define GPIO_CNF_INPUT_PULL_UPDOWN     2
+#define GPIO_CNF_OUTPUT_PUSHPULL       0
+#define GPIO_CNF_OUTPUT_OPENDRAIN      1
+#define GPIO_CNF_OUTPUT_ALTFN_PUSHPULL 2
+
+#define GPIO_USART1_TX       GPIO9
+#define GPIO_USART1_RE_TX    GPIO6
+#define GPIO_USART2_TX       GPIO2
+#define GPIO_USART2_RE_TX    GPIO5
+#define GPIO_USART3_TX       GPIO10
+#define GPIO_USART3_PR_TX    GPIO10
+#define GPIO_BANK_CAN1_RX    GPIOA
+#define GPIO_CAN1_RX         GPIO11
+#define GPIO_BANK_CAN1_TX    GPIOA
+#define GPIO_CAN1_TX         GPIO12
+#define GPIO_BANK_CAN2_RX    GPIOB
+#define GPIO_CAN2_RX         GPIO12
+#define GPIO_BANK_CAN2_TX    GPIOB
+#define GPIO_CAN2_TX         GPIO13
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_gpio_set_mode(uint32_t port, uint8_t mode, uint8_t cnf, uint16_t pins);
+uint16_t hal_gpio_get(uint32_t port, uint16_t pins);
+void hal_gpio_set(uint32_t port, uint16_t pins);
+void hal_gpio_clear(uint32_t port, uint16_t pins);
+void hal_gpio_toggle(uint32_t port, uint16_t pins);
+
+/* Simulation interface */
+void hal_gpio_host_set_input(uint32_t port, uint16_t pins, bool level);
+uint16_t hal_gpio_host_get_output(uint32_t port);
+uint8_t hal_gpio_host_get_mode(uint32_t port, int pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/gpio.h>
+
+static inline void hal_gpio_set_mode(uint32_t port, uint8_t mode, uint8_t cnf, uint16_t pins) { gpio_set_mode(port, mode, cnf, pins); }
+static inline uint16_t hal_gpio_get(uint32_t port, uint16_t pins) { return gpio_get(port, pins); }
+static inline void hal_gpio_set(uint32_t port, uint16_t pins) { gpio_set(port, pins); }
+static inline void hal_gpio_clear(uint32_t port, uint16_t pins) { gpio_clear(port, pins); }
+static inline void hal_gpio_toggle(uint32_t port, uint16_t pins) { gpio_toggle(port, pins); }
+
+#endif // HOST_BUILD
+
+#endif // HAL_GPIO_H_INCLUDED
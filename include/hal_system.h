@@ -0,0 +1,73 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_SYSTEM_H_INCLUDED
+#define HAL_SYSTEM_H_INCLUDED
+
+/** @brief Core functions: reset, interrupt masking, RTC and cycle counter
+ *
+ * On the target these are inline wrappers of libopencm3. With HOST_BUILD
+ * hal_system_host.cpp counts resets and interrupt masking, the RTC is set
+ * by the simulation and the cycle counter runs in nanoseconds.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_system_reset(void);
+void hal_irq_disable(void);
+void hal_irq_enable(void);
+uint32_t hal_irq_mask(uint32_t mask);
+uint32_t hal_rtc_get_counter(void);
+void hal_cycle_counter_enable(void);
+uint32_t hal_cycle_counter(void);
+
+/* Simulation interface */
+int hal_system_host_resets(void);
+bool hal_system_host_irq_disabled(void);
+void hal_rtc_host_set(uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/cm3/scb.h>
+#include <libopencm3/cm3/cortex.h>
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/stm32/rtc.h>
+
+static inline void hal_system_reset(void) { scb_reset_system(); }
+static inline void hal_irq_disable(void) { cm_disable_interrupts(); }
+static inline void hal_irq_enable(void) { cm_enable_interrupts(); }
+/** Mask (1) or unmask (0) interrupts, returns the previous state for restoring it */
+static inline uint32_t hal_irq_mask(uint32_t mask) { return cm_mask_interrupts(mask); }
+static inline uint32_t hal_rtc_get_counter(void) { return rtc_get_counter_val(); }
+static inline void hal_cycle_counter_enable(void) { dwt_enable_cycle_counter(); }
+static inline uint32_t hal_cycle_counter(void) { return DWT_CYCCNT; }
+
+#endif // HOST_BUILD
+
+#endif // HAL_SYSTEM_H_INCLUDED
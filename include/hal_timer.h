@@ -0,0 +1,103 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_TIMER_H_INCLUDED
+#define HAL_TIMER_H_INCLUDED
+
+/** @brief General purpose timer with four compare channels, as used by
+ * Stm32Scheduler
+ *
+ * Channels are numbered 0 to 3. On the target these are inline wrappers
+ * of libopencm3. With HOST_BUILD hal_timer_host.cpp simulates the counter
+ * and the compare flags, time is advanced by the simulation.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#define TIM1 0x40012C00
+#define TIM2 0x40000000
+#define TIM3 0x40000400
+#define TIM4 0x40000800
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_timer_setup(uint32_t timer, uint16_t prescaler, uint16_t period);
+void hal_timer_enable(uint32_t timer, bool enable);
+void hal_timer_set_counter(uint32_t timer, uint16_t value);
+uint16_t hal_timer_get_counter(uint32_t timer);
+void hal_timer_setup_compare(uint32_t timer, int channel, uint16_t value);
+bool hal_timer_compare_pending(uint32_t timer, int channel);
+void hal_timer_clear_compare(uint32_t timer, int channel);
+void hal_timer_advance_compare(uint32_t timer, int channel, uint16_t ticks);
+
+/* Simulation interface */
+void hal_timer_host_tick(uint32_t timer, uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/timer.h>
+
+/* return CCRc of TIMt */
+#define HAL_TIM_CCR(t,c) (*(volatile uint32_t *)(&TIM_CCR1(t) + (c)))
+
+/** Upcounting with auto preload */
+static inline void hal_timer_setup(uint32_t timer, uint16_t prescaler, uint16_t period)
+{
+   timer_enable_preload(timer);
+   timer_direction_up(timer);
+   timer_set_prescaler(timer, prescaler);
+   timer_set_period(timer, period);
+}
+
+static inline void hal_timer_enable(uint32_t timer, bool enable)
+{
+   if (enable)
+      timer_enable_counter(timer);
+   else
+      timer_disable_counter(timer);
+}
+
+static inline void hal_timer_set_counter(uint32_t timer, uint16_t value) { timer_set_counter(timer, value); }
+static inline uint16_t hal_timer_get_counter(uint32_t timer) { return timer_get_counter(timer); }
+
+/** Set compare value of channel and enable its interrupt */
+static inline void hal_timer_setup_compare(uint32_t timer, int channel, uint16_t value)
+{
+   static const enum tim_oc_id ocMap[] = { TIM_OC1, TIM_OC2, TIM_OC3, TIM_OC4 };
+
+   timer_set_oc_mode(timer, ocMap[channel], TIM_OCM_ACTIVE);
+   timer_set_oc_value(timer, ocMap[channel], value);
+   timer_enable_irq(timer, TIM_DIER_CC1IE << channel);
+}
+
+static inline bool hal_timer_compare_pending(uint32_t timer, int channel) { return timer_get_flag(timer, TIM_SR_CC1IF << channel); }
+static inline void hal_timer_clear_compare(uint32_t timer, int channel) { timer_clear_flag(timer, TIM_SR_CC1IF << channel); }
+static inline void hal_timer_advance_compare(uint32_t timer, int channel, uint16_t ticks) { HAL_TIM_CCR(timer, channel) += ticks; }
+
+#endif // HOST_BUILD
+
+#endif // HAL_TIMER_H_INCLUDED
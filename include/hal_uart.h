@@ -0,0 +1,147 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HAL_UART_H_INCLUDED
+#define HAL_UART_H_INCLUDED
+
+/** @brief USART with DMA transfers, as used by the terminal
+ *
+ * On the target these are inline wrappers of libopencm3, each one a
+ * sequence of calls Terminal used to make directly. With HOST_BUILD,
+ * hal_uart_host.cpp simulates the DMA channels so received characters
+ * can be injected and sent characters collected.
+ */
+
+#include <stdint.h>
+
+#ifdef HOST_BUILD
+
+#define USART1 0x40013800
+#define USART2 0x40004400
+#define USART3 0x40004800
+
+#define DMA_CHANNEL1 1
+#define DMA_CHANNEL2 2
+#define DMA_CHANNEL3 3
+#define DMA_CHANNEL4 4
+#define DMA_CHANNEL5 5
+#define DMA_CHANNEL6 6
+#define DMA_CHANNEL7 7
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void hal_uart_init(uint32_t usart, uint32_t baudrate, uint8_t dmatx, uint8_t dmarx);
+void hal_uart_enable(uint32_t usart);
+void hal_uart_set_format(uint32_t usart, uint32_t baudrate, int stopbits);
+void hal_uart_send_blocking(uint32_t usart, char c);
+void hal_uart_wait_send_ready(uint32_t usart);
+bool hal_uart_rx_ready(uint32_t usart);
+uint16_t hal_uart_recv(uint32_t usart);
+void hal_uart_disable_tx_dma(uint32_t usart, uint8_t dmatx);
+void hal_uart_dma_rx_start(uint8_t dmarx, char* buf, int size);
+int hal_uart_dma_rx_remaining(uint8_t dmarx);
+bool hal_uart_dma_tx_done(uint8_t dmatx);
+void hal_uart_dma_tx_start(uint8_t dmatx, const char* buf, int len);
+
+/* Simulation interface */
+int hal_uart_host_receive(uint32_t usart, const char* data, int len);
+int hal_uart_host_transmitted(uint32_t usart, char* buf, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+#include <libopencm3/stm32/usart.h>
+#include <libopencm3/stm32/dma.h>
+
+/** Configure 8N2 with DMA requests enabled and set up both DMA channels */
+static inline void hal_uart_init(uint32_t usart, uint32_t baudrate, uint8_t dmatx, uint8_t dmarx)
+{
+   usart_set_baudrate(usart, baudrate);
+   usart_set_databits(usart, 8);
+   usart_set_stopbits(usart, USART_STOPBITS_2);
+   usart_set_mode(usart, USART_MODE_TX_RX);
+   usart_set_parity(usart, USART_PARITY_NONE);
+   usart_set_flow_control(usart, USART_FLOWCONTROL_NONE);
+   usart_enable_rx_dma(usart);
+   usart_enable_tx_dma(usart);
+
+   dma_channel_reset(DMA1, dmatx);
+   dma_set_read_from_memory(DMA1, dmatx);
+   dma_set_peripheral_address(DMA1, dmatx, (uint32_t)&USART_DR(usart));
+   dma_set_peripheral_size(DMA1, dmatx, DMA_CCR_PSIZE_8BIT);
+   dma_set_memory_size(DMA1, dmatx, DMA_CCR_MSIZE_8BIT);
+   dma_enable_memory_increment_mode(DMA1, dmatx);
+
+   dma_channel_reset(DMA1, dmarx);
+   dma_set_peripheral_address(DMA1, dmarx, (uint32_t)&USART_DR(usart));
+   dma_set_peripheral_size(DMA1, dmarx, DMA_CCR_PSIZE_8BIT);
+   dma_set_memory_size(DMA1, dmarx, DMA_CCR_MSIZE_8BIT);
+   dma_enable_memory_increment_mode(DMA1, dmarx);
+   dma_enable_channel(DMA1, dmarx);
+}
+
+static inline void hal_uart_enable(uint32_t usart) { usart_enable(usart); }
+
+static inline void hal_uart_set_format(uint32_t usart, uint32_t baudrate, int stopbits)
+{
+   usart_set_baudrate(usart, baudrate);
+   usart_set_stopbits(usart, stopbits == 1 ? USART_STOPBITS_1 : USART_STOPBITS_2);
+}
+
+static inline void hal_uart_send_blocking(uint32_t usart, char c) { usart_send_blocking(usart, c); }
+static inline void hal_uart_wait_send_ready(uint32_t usart) { usart_wait_send_ready(usart); }
+static inline bool hal_uart_rx_ready(uint32_t usart) { return usart_get_flag(usart, USART_SR_RXNE); }
+static inline uint16_t hal_uart_recv(uint32_t usart) { return usart_recv(usart); }
+
+static inline void hal_uart_disable_tx_dma(uint32_t usart, uint8_t dmatx)
+{
+   dma_disable_channel(DMA1, dmatx);
+   usart_disable_tx_dma(usart);
+}
+
+/** (Re)start reception into buf from the beginning */
+static inline void hal_uart_dma_rx_start(uint8_t dmarx, char* buf, int size)
+{
+   dma_disable_channel(DMA1, dmarx);
+   dma_set_memory_address(DMA1, dmarx, (uint32_t)buf);
+   dma_set_number_of_data(DMA1, dmarx, size);
+   dma_enable_channel(DMA1, dmarx);
+}
+
+/** @return number of characters that can still be received into the buffer */
+static inline int hal_uart_dma_rx_remaining(uint8_t dmarx) { return dma_get_number_of_data(DMA1, dmarx); }
+static inline bool hal_uart_dma_tx_done(uint8_t dmatx) { return dma_get_interrupt_flag(DMA1, dmatx, DMA_TCIF); }
+
+static inline void hal_uart_dma_tx_start(uint8_t dmatx, const char* buf, int len)
+{
+   dma_disable_channel(DMA1, dmatx);
+   dma_set_number_of_data(DMA1, dmatx, len);
+   dma_set_memory_address(DMA1, dmatx, (uint32_t)buf);
+   dma_clear_interrupt_flags(DMA1, dmatx, DMA_TCIF);
+   dma_enable_channel(DMA1, dmatx);
+}
+
+#endif // HOST_BUILD
+
+#endif // HAL_UART_H_INCLUDED
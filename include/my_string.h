@@ -37,6 +37,7 @@ int my_strlen(const char *str);
 const char *my_strchr(const char *str, const char c);
 int my_ltoa(char *buf, int val, int base);
 int my_atoi(const char *str);
+unsigned int my_atoui(const char *str);
 char *my_trim(char *str);
 void memcpy32(int* target, int *source, int length);
 void memset32(int* target, int value, int length);
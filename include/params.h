@@ -23,10 +23,30 @@
 #include "param_prj.h"
 #include "my_fp.h"
 
+/* Define PARAM_HISTORY_SIZE in param_prj.h to record the last n parameter
+ * changes in RAM. Each entry takes 16 bytes, recording is O(1) and only
+ * happens when Set() or SetIntChecked() actually change a parameter (not a
+ * display value). The unchecked SetInt()/SetFlt() used by the firmware itself
+ * are not recorded. */
+#ifndef PARAM_HISTORY_SIZE
+#define PARAM_HISTORY_SIZE 0
+#endif
+
+/* Besides PARAM_ENTRY and VALUE_ENTRY the list may contain
+ * TYPED_ENTRY(category, name, unit, min, max, def, id, type) and
+ * TYPED_VALUE_ENTRY(name, unit, id, type) where type is one of
+ * FIXED, INT, ENUM or BITFIELD. Non-fixed kinds store plain integers with
+ * the full 32 bit range, min/max/def are given as integers. Bitfields are
+ * not range checked.
+ * The list is checked at compile time: ids must be unique (except 0) and fit
+ * in 16 bits, defaults must lie within min/max. */
+
 namespace Param
 {
    #define PARAM_ENTRY(category, name, unit, min, max, def, id) name,
    #define VALUE_ENTRY(name, unit, id) name,
+   #define TYPED_ENTRY(category, name, unit, min, max, def, id, type) name,
+   #define TYPED_VALUE_ENTRY(name, unit, id, type) name,
    typedef enum
    {
        PARAM_LIST
@@ -35,6 +55,8 @@ namespace Param
    } PARAM_NUM;
    #undef PARAM_ENTRY
    #undef VALUE_ENTRY
+   #undef TYPED_ENTRY
+   #undef TYPED_VALUE_ENTRY
 
    typedef enum
    {
@@ -49,33 +71,130 @@ namespace Param
       FLAG_HIDDEN = 1
    } PARAM_FLAG;
 
+   typedef enum
+   {
+      KIND_FIXED,
+      KIND_INT,
+      KIND_ENUM,
+      KIND_BITFIELD
+   } PARAM_KIND;
+
+   /** Who changed a parameter, recorded in the change history */
+   typedef enum
+   {
+      SRC_APP,
+      SRC_TERMINAL,
+      SRC_SDO,
+      SRC_CAN,
+      SRC_LAST
+   } PARAM_SOURCE;
+
+   /** One change history entry, values in storage format, see GetRaw() */
+   typedef struct
+   {
+      uint32_t time;
+      int32_t oldVal;
+      int32_t newVal;
+      uint16_t param;
+      uint8_t source;
+   } HistoryEntry;
+
+   /** Descriptive attributes, numeric attributes are accessed with GetMin() etc. */
    typedef struct
    {
       char const *category;
       char const *name;
       char const *unit;
-      s32fp min;
-      s32fp max;
-      s32fp def;
-      uint32_t id;
    } Attributes;
 
-   int Set(PARAM_NUM ParamNum, s32fp ParamVal);
+   int Set(PARAM_NUM ParamNum, s32fp ParamVal, PARAM_SOURCE source = SRC_APP);
+   int SetIntChecked(PARAM_NUM ParamNum, int ParamVal, PARAM_SOURCE source = SRC_APP);
+   int SetRawChecked(PARAM_NUM ParamNum, int32_t ParamVal, PARAM_SOURCE source = SRC_APP);
    s32fp  Get(PARAM_NUM ParamNum);
    int    GetInt(PARAM_NUM ParamNum);
+   PARAM_KIND GetKind(PARAM_NUM ParamNum);
    s32fp  GetScl(PARAM_NUM ParamNum);
    bool   GetBool(PARAM_NUM ParamNum);
+   int32_t GetRaw(PARAM_NUM ParamNum);
+   void SetRaw(PARAM_NUM ParamNum, int32_t ParamVal);
    void SetInt(PARAM_NUM ParamNum, int ParamVal);
    void SetFlt(PARAM_NUM ParamNum, s32fp ParamVal);
    PARAM_NUM NumFromString(const char *name);
    PARAM_NUM NumFromId(uint32_t id);
    const Attributes *GetAttrib(PARAM_NUM ParamNum);
+   s32fp GetMin(PARAM_NUM ParamNum);
+   s32fp GetMax(PARAM_NUM ParamNum);
+   s32fp GetDefault(PARAM_NUM ParamNum);
+   uint32_t GetId(PARAM_NUM ParamNum);
    int IsParam(PARAM_NUM ParamNum);
    void LoadDefaults();
    void SetFlagsRaw(PARAM_NUM param, uint8_t rawFlags);
    void SetFlag(PARAM_NUM param, PARAM_FLAG flag);
    void ClearFlag(PARAM_NUM param, PARAM_FLAG flag);
    PARAM_FLAG GetFlag(PARAM_NUM param);
+   void SetHistoryTime(uint32_t time);
+   bool GetHistory(uint32_t n, HistoryEntry& entry);
+   void ClearHistory();
+
+   /** Kind of a parameter as a constant expression */
+   #define PARAM_ENTRY(category, name, unit, min, max, def, id) ParamNum == name ? KIND_FIXED :
+   #define VALUE_ENTRY(name, unit, id) ParamNum == name ? KIND_FIXED :
+   #define TYPED_ENTRY(category, name, unit, min, max, def, id, type) ParamNum == name ? KIND_##type :
+   #define TYPED_VALUE_ENTRY(name, unit, id, type) ParamNum == name ? KIND_##type :
+   constexpr PARAM_KIND KindOf(PARAM_NUM ParamNum)
+   {
+      return PARAM_LIST KIND_FIXED;
+   }
+   #undef PARAM_ENTRY
+   #undef VALUE_ENTRY
+   #undef TYPED_ENTRY
+   #undef TYPED_VALUE_ENTRY
+
+   /* Accessors with the kind resolved at compile time, e.g.
+    * Param::Get<Param::boost>(). They behave like the functions of the same
+    * name but only load or store in storage format, without the run time
+    * kind lookup. Use them in control loops and interrupts, the generic
+    * functions remain for SDO, terminal and CAN maps */
+   template<PARAM_NUM ParamNum> inline s32fp Get()
+   {
+      int32_t val = GetRaw(ParamNum);
+
+      if (KindOf(ParamNum) == KIND_FIXED)
+         return val;
+
+      val = val > FP_TOINT(INT32_MAX) ? FP_TOINT(INT32_MAX) : val < FP_TOINT(INT32_MIN) ? FP_TOINT(INT32_MIN) : val;
+      return FP_FROMINT(val);
+   }
+
+   template<PARAM_NUM ParamNum> inline int GetInt()
+   {
+      return KindOf(ParamNum) == KIND_FIXED ? FP_TOINT(GetRaw(ParamNum)) : GetRaw(ParamNum);
+   }
+
+   template<PARAM_NUM ParamNum> inline bool GetBool()
+   {
+      return GetInt<ParamNum>() == 1;
+   }
+
+   template<PARAM_NUM ParamNum> inline int Set(s32fp ParamVal, PARAM_SOURCE source = SRC_APP)
+   {
+      return SetRawChecked(ParamNum, KindOf(ParamNum) == KIND_FIXED ? ParamVal : ParamVal >> FRAC_DIGITS, source);
+   }
+
+   template<PARAM_NUM ParamNum> inline int SetIntChecked(int ParamVal, PARAM_SOURCE source = SRC_APP)
+   {
+      return SetRawChecked(ParamNum, KindOf(ParamNum) == KIND_FIXED ? FP_FROMINT(ParamVal) : ParamVal, source);
+   }
+
+   template<PARAM_NUM ParamNum> inline void SetInt(int ParamVal)
+   {
+      SetRaw(ParamNum, KindOf(ParamNum) == KIND_FIXED ? FP_FROMINT(ParamVal) : ParamVal);
+   }
+
+   template<PARAM_NUM ParamNum> inline void SetFlt(s32fp ParamVal)
+   {
+      SetRaw(ParamNum, KindOf(ParamNum) == KIND_FIXED ? ParamVal : ParamVal >> FRAC_DIGITS);
+   }
 }
 
 //User defined callback
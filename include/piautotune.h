@@ -0,0 +1,105 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PIAUTOTUNE_H
+#define PIAUTOTUNE_H
+
+#include "params.h"
+
+/** @brief Relay feedback autotuning for PiController
+ *
+ * While running, Run() is called instead of PiController::Run() and drives
+ * the plant with a relay output bias +/- amplitude. This makes the loop
+ * oscillate at its critical period. Once enough periods have been measured
+ * the ultimate gain Ku = 4 * amplitude / (pi * a) and period Tu are
+ * converted to PI gains using the Ziegler-Nichols rules
+ * kp = 0.45 * Ku, ki = kp / (Tu / 1.2) and written to the given parameters.
+ *
+ * PiController adds ki / 32 digits at once whenever its error sum crosses
+ * the calling frequency. Fast loops like current control yield ki in the
+ * order of 1000 * kp by Ziegler-Nichols, such steps cause a limit cycle.
+ * ki is therefore given for a calling frequency GetFrequency() that may be
+ * lower than the real one, so that ki <= kp and an integrator step is no
+ * larger than a proportional step. Configure PiController with
+ * SetCallingFrequency(GetFrequency()), the integral action stays the same.
+ */
+class PiAutotune
+{
+   public:
+      enum State
+      {
+         IDLE, RUNNING, DONE, FAILED
+      };
+
+      /** Construct autotuner
+       * \param kpParam parameter that receives the proportional gain
+       * \param kiParam parameter that receives the integral gain
+       */
+      PiAutotune(Param::PARAM_NUM kpParam, Param::PARAM_NUM kiParam);
+
+      /** Start relay experiment
+       * \param ref set point to oscillate around
+       * \param bias actuator value that roughly yields ref
+       * \param amplitude relay amplitude in actuator digits
+       * \param hysteresis error band in which the relay doesn't switch
+       * \param frequency calling frequency of Run() in Hz
+       * \param cycles number of oscillation periods to average
+       */
+      void Start(s32fp ref, int32_t bias, int32_t amplitude, s32fp hysteresis, int frequency, int cycles);
+
+      /** Abort experiment, state becomes IDLE */
+      void Stop() { state = IDLE; }
+
+      /** Run one step of the relay experiment
+       * \param curVal currently measured value
+       * \return new actuator value
+       */
+      int32_t Run(s32fp curVal);
+
+      State GetState() { return state; }
+      int GetKp() { return kp; }
+      int GetKi() { return ki; }
+      /** Calling frequency to configure PiController with for GetKi() */
+      int GetFrequency() { return kiFrequency; }
+
+   private:
+      void Calculate();
+
+      Param::PARAM_NUM kpParam;
+      Param::PARAM_NUM kiParam;
+      State state;
+      s32fp refVal;
+      int32_t bias;
+      int32_t amplitude;
+      s32fp hysteresis;
+      int frequency;
+      int cycles;
+      bool relayHigh;
+      uint32_t calls;
+      uint32_t lastRisingEdge;
+      int periodCount;
+      uint32_t periodSum;
+      s32fp ampSum;
+      s32fp maxVal;
+      s32fp minVal;
+      int kp;
+      int ki;
+      int kiFrequency;
+};
+
+#endif // PIAUTOTUNE_H
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PIREGULATOR64_H
+#define PIREGULATOR64_H
+
+#include "my_fp.h"
+#include "my_math.h"
+
+/** @brief PI controller without divisions in Run()
+ *
+ * Computes exactly the same output as PiController. The divisions by the
+ * calling frequency and by ki + 1 (anti windup) are replaced by multiplying
+ * with reciprocals that are precomputed whenever gains or calling frequency
+ * change. The reciprocals truncate like the division operator for all
+ * dividends up to 2^31 - 1 in magnitude, see CalcReciprocal().
+ * Unlike PiController, err * kp is evaluated in 64 bit and the error sum
+ * saturates at +-(2^31 - 1) instead of overflowing.
+ */
+class PiController64
+{
+   public:
+      /** Default constructor */
+      PiController64();
+
+      /** Set regulator proportional and integral gain.
+       * \param kp New value to set for proportional gain
+       * \param ki New value for integral gain
+       */
+      void SetGains(int kp, int ki)
+      {
+         this->kp = kp;
+         this->ki = ki;
+         CalcFactors();
+      }
+
+      void SetProportionalGain(int kp) { this->kp = kp; }
+      void SetIntegralGain(int ki) { this->ki = ki; CalcFactors(); }
+
+      /** Set regulator target set point
+       * \param val regulator target
+       */
+      void SetRef(s32fp val) { refVal = val; }
+
+      s32fp GetRef() { return refVal; }
+
+      /** Set maximum regulator output
+        * \param val actuator saturation value
+        * \post the integrator will stop once this value is surpassed
+        */
+      void SetMinMaxY(int32_t valMin, int32_t valMax) { minY = valMin; maxY = valMax; }
+
+      /** Set calling frequency
+       * \param val New value to set
+       */
+      void SetCallingFrequency(int val) { frequency = val; CalcFactors(); }
+
+      /** Run regulator to obtain a new actuator value
+       * \param curVal currently measured value
+       * \return new actuator value
+       */
+      int32_t Run(s32fp curVal);
+
+      /** Reset integrator to 0 */
+      void ResetIntegrator() { esum = 0; }
+
+      /** Preload Integrator to yield a certain output
+       * @pre SetCallingFrequency() and SetGains() must be called first
+      */
+      void PreloadIntegrator(int32_t yieldedOutput);
+
+   protected:
+
+   private:
+      /** Multiplier and shift for truncating division by a constant */
+      struct Reciprocal
+      {
+         uint32_t mul;
+         uint8_t shift;
+         bool negative;
+      };
+
+      void CalcFactors();
+      static Reciprocal CalcReciprocal(int32_t divisor);
+      static int32_t Divide(int32_t dividend, const Reciprocal& r);
+
+      int32_t kp;
+      int32_t ki;
+      Reciprocal invFrequency; //!< replaces division by frequency
+      Reciprocal invKiPlus1; //!< replaces division by ki + 1
+      int32_t esum; //!< Error sum
+      s32fp refVal;
+      int32_t frequency; //!< Calling frequency
+      int32_t maxY;
+      int32_t minY;
+};
+
+#endif // PIREGULATOR64_H
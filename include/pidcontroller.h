@@ -0,0 +1,174 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PIDCONTROLLER_H
+#define PIDCONTROLLER_H
+
+#include "my_fp.h"
+#include "my_math.h"
+
+/** @brief Configurable P/PI/PID controller with optional feed forward
+ *
+ * Terms that are not selected by the template parameters are removed by the
+ * compiler, e.g. PidController<false, false, false> is a plain P controller.
+ * - Proportional term uses setpoint weighting: kp * (b * ref - cur)
+ * - Integral term uses clamping anti windup, i.e. it stops integrating
+ *   while the output is saturated and the error drives it further out
+ * - Derivative term acts on the measurement only so set point steps
+ *   don't kick the output. It is low pass filtered with 2^shift calls time constant
+ * - Feed forward term adds kff * ff to the output
+ *
+ * Gains are integers like those of PiController, output is FP_TOINT of the sum
+ * of all terms. All terms are accumulated in 64 bit.
+ */
+template <bool IntegralTerm, bool DerivativeTerm, bool FeedForwardTerm>
+class PidController
+{
+   public:
+      PidController()
+       : kp(0), ki(0), kd(0), kff(0), kiByFrequency(0), kdTimesFrequency(0),
+         setpointWeight(FP_FROMINT(1)), frequency(1), dFilterShift(0),
+         refVal(0), ffVal(0), lastVal(0), isum(0), dFiltered(0), minY(0), maxY(0)
+      {
+      }
+
+      /** Set regulator proportional, integral and derivative gain.
+       * \param kp New value to set for proportional gain
+       * \param ki New value for integral gain, ignored without integral term
+       * \param kd New value for derivative gain, ignored without derivative term
+       */
+      void SetGains(int kp, int ki, int kd)
+      {
+         this->kp = kp;
+         this->ki = ki;
+         this->kd = kd;
+         CalcFactors();
+      }
+
+      /** Set gain of feed forward input */
+      void SetFeedForwardGain(int kff) { this->kff = kff; }
+
+      /** Set weight of set point in proportional term
+       * \param b weight, 1 yields a plain error, 0 acts on measurement only
+       */
+      void SetSetpointWeight(s32fp b) { setpointWeight = b; }
+
+      /** Set derivative low pass filter
+       * \param shift filter time constant is 2^shift calls
+       */
+      void SetDerivativeFilter(int shift) { dFilterShift = shift; }
+
+      /** Set regulator target set point
+       * \param val regulator target
+       */
+      void SetRef(s32fp val) { refVal = val; }
+
+      s32fp GetRef() { return refVal; }
+
+      /** Set feed forward input, e.g. a model based estimate of the output
+       * \param val feed forward value
+       */
+      void SetFeedForward(s32fp val) { ffVal = val; }
+
+      /** Set regulator output limits
+        * \param valMin minimum output
+        * \param valMax maximum output
+        */
+      void SetMinMaxY(int32_t valMin, int32_t valMax) { minY = valMin; maxY = valMax; }
+
+      /** Set calling frequency
+       * \param val New value to set
+       */
+      void SetCallingFrequency(int val) { frequency = val; CalcFactors(); }
+
+      /** Run regulator to obtain a new actuator value
+       * \param curVal currently measured value
+       * \return new actuator value, limited to [minY, maxY]
+       */
+      int32_t Run(s32fp curVal)
+      {
+         s32fp err = refVal - curVal;
+         int64_t sum = (int64_t)kp * (FP_MUL(setpointWeight, refVal) - curVal);
+         int64_t isumNew = 0;
+
+         if (FeedForwardTerm)
+         {
+            sum += (int64_t)kff * ffVal;
+         }
+
+         if (DerivativeTerm)
+         {
+            int64_t dRaw = (int64_t)kdTimesFrequency * (lastVal - curVal);
+            lastVal = curVal;
+            dFiltered += (dRaw - dFiltered) >> dFilterShift;
+            sum += dFiltered;
+         }
+
+         if (IntegralTerm)
+         {
+            isumNew = isum + (int64_t)err * kiByFrequency;
+            sum += isumNew >> FRAC_BITS;
+         }
+
+         int64_t y = sum >> CST_DIGITS;
+         int64_t ylim = MAX(y, minY);
+         ylim = MIN(ylim, maxY);
+
+         if (IntegralTerm && !((y > maxY && err > 0) || (y < minY && err < 0)))
+         {
+            isum = isumNew;
+         }
+
+         return ylim;
+      }
+
+      /** Reset integrator and derivative filter */
+      void ResetIntegrator() { isum = 0; dFiltered = 0; }
+
+      /** Preload Integrator to yield a certain output */
+      void PreloadIntegrator(int32_t yieldedOutput) { isum = ((int64_t)yieldedOutput << CST_DIGITS) << FRAC_BITS; }
+
+   private:
+      /** Fractional bits of integrator */
+      static const int FRAC_BITS = 16;
+
+      void CalcFactors()
+      {
+         kiByFrequency = ((int64_t)ki << FRAC_BITS) / frequency;
+         kdTimesFrequency = kd * frequency;
+      }
+
+      int32_t kp;
+      int32_t ki;
+      int32_t kd;
+      int32_t kff;
+      int32_t kiByFrequency; //!< ki / frequency with FRAC_BITS fractional bits
+      int32_t kdTimesFrequency;
+      s32fp setpointWeight;
+      int32_t frequency; //!< Calling frequency
+      int dFilterShift;
+      s32fp refVal;
+      s32fp ffVal;
+      s32fp lastVal; //!< Last measurement for derivative term
+      int64_t isum; //!< ki weighted error sum with FRAC_BITS fractional bits
+      int64_t dFiltered;
+      int32_t minY;
+      int32_t maxY;
+};
+
+#endif // PIDCONTROLLER_H
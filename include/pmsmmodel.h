@@ -0,0 +1,105 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PMSMMODEL_H
+#define PMSMMODEL_H
+
+#include <stdint.h>
+#include "my_fp.h"
+
+/** @brief Plant model of a PMSM with inverter for closed loop simulation
+ *
+ * Takes the duty cycles calculated by FocChannel or SineChannel, averages
+ * them over the PWM period and returns phase currents, rotor angle and
+ * speed in the scaling the control code expects. The model works in
+ * floating point since accuracy matters more than speed; it is meant for
+ * the host but runs on the target with soft float as a virtual motor.
+ *
+ * Model: dq voltage equations with Ld/Lq saliency, mechanical equation
+ * with inertia, viscous friction and load torque. Dead time and
+ * switching ripple are not modelled.
+ */
+class PmsmModel
+{
+   public:
+      PmsmModel();
+
+      /** Set electrical parameters
+       * \param rs phase resistance in Ohm
+       * \param ld d inductance in H
+       * \param lq q inductance in H
+       * \param fluxLinkage permanent magnet flux linkage in Vs
+       * \param polePairs number of pole pairs
+       */
+      void SetElectricalParameters(float rs, float ld, float lq, float fluxLinkage, int polePairs);
+
+      /** Set mechanical parameters
+       * \param inertia in kgm², 0 keeps the speed set with SetSpeed()
+       * \param friction viscous friction in Nm/(rad/s)
+       */
+      void SetMechanicalParameters(float inertia, float friction);
+
+      /** Set calling frequency of Step() in Hz and number of integration steps per call */
+      void SetCallingFrequency(int frequency, int subSteps);
+
+      /** Set PWM range that corresponds to the full DC link voltage, 65536 for FOC and SineCore */
+      void SetPwmRange(int32_t range) { pwmRange = range; }
+
+      void SetLoadTorque(float torque) { loadTorque = torque; }
+      void SetSpeed(float rpm);
+
+      /** Advance model by one control period
+       * \param dutyCycles duty cycles of the three phases, 0..pwm range
+       * \param udc DC link voltage
+       */
+      void Step(const int32_t* dutyCycles, s32fp udc);
+      void Step(const uint32_t* dutyCycles, s32fp udc) { Step((const int32_t*)dutyCycles, udc); }
+
+      /** Get phase currents in A, same scale as FOC::ParkClarke() expects */
+      s32fp GetIl1();
+      s32fp GetIl2();
+      /** Get electrical rotor angle, 0..65535 = 0..360° */
+      uint16_t GetAngle() { return (uint16_t)(int32_t)(angle * (65536.0f / TWO_PI)); }
+      /** Get mechanical speed in rpm */
+      float GetSpeed();
+      /** Get electrical frequency in Hz */
+      float GetFrequency() { return omega / TWO_PI; }
+      float GetTorque() { return torque; }
+      float GetId() { return id; }
+      float GetIq() { return iq; }
+      /** Get DC link current drawn from the supply in A */
+      float GetIdc() { return idc; }
+
+   private:
+      static const float TWO_PI;
+
+      float rs, ld, lq, fluxLinkage;
+      int polePairs;
+      float inertia, friction, loadTorque;
+      float dt;
+      int subSteps;
+      int32_t pwmRange;
+      float id, iq;
+      float il1, il2;
+      float angle; //!< electrical, 0..2pi
+      float omega; //!< electrical rad/s
+      float torque;
+      float idc;
+};
+
+#endif // PMSMMODEL_H
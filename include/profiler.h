@@ -0,0 +1,100 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/** @brief Cycle count profiling of code regions
+ *
+ * The project lists its probes in profiler_prj.h:
+ * #define PROFILE_LIST \
+ *    PROFILE_ENTRY(pwm, Param::pwmcycles, Param::PARAM_INVALID) \
+ *    PROFILE_ENTRY(canrx, Param::PARAM_INVALID, Param::PARAM_INVALID)
+ * The two params receive average and maximum cycles on Publish().
+ *
+ * Wrap code with PROFILE_START(pwm); ... PROFILE_STOP(pwm);
+ * Unless PROFILING is defined to 1 the macros expand to nothing and no
+ * probe table is allocated.
+ */
+
+#include <stdint.h>
+#include "params.h"
+#include "profiler_prj.h"
+
+#ifndef PROFILING
+#define PROFILING 0
+#endif
+
+#define PROFILE_ENTRY(name, avgParam, maxParam) PROF_##name,
+typedef enum
+{
+   PROFILE_LIST
+   PROFILE_LAST
+} PROFILE_NUM;
+#undef PROFILE_ENTRY
+
+#if PROFILING
+#include "hal_system.h"
+#define PROFILE_START(name) uint32_t profStart_##name = hal_cycle_counter()
+#define PROFILE_STOP(name) Profiler::Record(PROF_##name, hal_cycle_counter() - profStart_##name)
+#else
+#define PROFILE_START(name)
+#define PROFILE_STOP(name)
+#endif
+
+class Terminal;
+
+class Profiler
+{
+   public:
+      /** Enable DWT cycle counter and reset statistics */
+      static void Init();
+      /** Calculate averages since the last call and write them to the params.
+       * Call periodically, e.g. every 100 ms, so the cycle sums do not overflow
+       */
+      static void Publish();
+      /** Reset minimum and maximum */
+      static void Reset();
+      /** Terminal command, prints min/max/avg cycles of all probes. Pass "reset" to clear min/max */
+      static void PrintTable(Terminal* term, char* arg);
+
+#if PROFILING
+      static void Record(PROFILE_NUM probe, uint32_t cycles)
+      {
+         Probe& p = probes[probe];
+         p.sum += cycles;
+         p.count++;
+         if (cycles < p.min) p.min = cycles;
+         if (cycles > p.max) p.max = cycles;
+      }
+
+   private:
+      struct Probe
+      {
+         uint32_t min;
+         uint32_t max;
+         uint32_t sum;
+         uint32_t count;
+         uint32_t avg;
+      };
+
+      static Probe probes[PROFILE_LAST];
+#endif // PROFILING
+};
+
+#endif // PROFILER_H
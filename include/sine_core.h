@@ -21,22 +21,74 @@
 
 #include "my_fp.h"
 
+namespace PwmMode {
+   /** Zero sequence injection, SVPWM centers all phases, the discontinuous
+    * modes clamp one phase per sector to a DC rail and save a third of the switching.
+    * - DPWMMIN/DPWMMAX always clamp to the negative/positive rail
+    * - DPWM1 clamps the phase with the largest voltage, centered on its peak
+    * - DPWM0/DPWM2 clamp intervals 30° ahead of/behind the voltage peak,
+    *   suited for leading/lagging power factor
+    */
+   enum PwmMode
+   {
+      SVPWM,
+      DPWMMIN,
+      DPWMMAX,
+      DPWM0,
+      DPWM1,
+      DPWM2,
+      LAST
+   };
+}
+
+/** @brief Sine wave generation state of one motor */
+class SineChannel
+{
+   public:
+      SineChannel();
+      void Calc(uint16_t angle);
+      /** Set amplitude of the synthesized sine wave, largest value is 37813 */
+      void SetAmp(uint32_t amp) { ampl = amp; }
+      uint32_t GetAmp() { return ampl; }
+      void SetPwmMode(PwmMode::PwmMode mode) { pwmMode = mode; }
+      void SetDeadTimeCompensation(int32_t comp, s32fp band);
+      /** Set phase currents used for dead time compensation in the next Calc() */
+      void SetPhaseCurrents(s32fp il1, s32fp il2) { this->il1 = il1; this->il2 = il2; }
+      uint32_t DutyCycles[3];
+
+   private:
+      uint32_t ampl;
+      PwmMode::PwmMode pwmMode;
+      s32fp il1;
+      s32fp il2;
+      s32fp dtBand;
+      int32_t dtGain;
+};
+
 class SineCore
 {
    public:
-      static void Calc(uint16_t angle);
+      static void Calc(uint16_t angle) { defaultChannel.Calc(angle); }
       static s32fp Sine(uint16_t angle);
       static s32fp Cosine(uint16_t angle);
       static uint16_t Atan2(int32_t cos, int32_t sin);
-      static void SetAmp(uint32_t amp);
-      static uint32_t GetAmp();
+      static uint16_t Atan2Table(int32_t cos, int32_t sin);
+      static void SetAmp(uint32_t amp) { defaultChannel.SetAmp(amp); }
+      static uint32_t GetAmp() { return defaultChannel.GetAmp(); }
+      static void SetPwmMode(PwmMode::PwmMode mode) { defaultChannel.SetPwmMode(mode); }
       static int32_t CalcSVPWMOffset(int32_t a, int32_t b, int32_t c);
-      static uint32_t DutyCycles[3];
+      static int32_t CalcPWMOffset(int32_t a, int32_t b, int32_t c, int32_t halfRange, PwmMode::PwmMode mode);
+      static int32_t CalcDeadTimeGain(int32_t comp, s32fp band);
+      static int32_t DeadTimeCompensation(s32fp current, s32fp band, int32_t gain);
+      static SineChannel defaultChannel;
+      static uint32_t (&DutyCycles)[3];
       static uint32_t Offset;
       static const int BITS;
       static const uint16_t MAXAMP;
 
    private:
+      friend class SineChannel;
+
       static int32_t SineLookup(uint16_t Arg);
       static int32_t MultiplyAmplitude(uint16_t Amplitude, int32_t Baseval);
       static int32_t min(int32_t a, int32_t b);
@@ -44,8 +96,8 @@ class SineCore
 
       /** Minimum pulse width in normalized digits */
       static const uint32_t minPulse;
-      static uint32_t ampl;
       static const int16_t SinTab[]; /* sine LUT */
+      static const uint16_t AtanTab[]; /* atan LUT for Atan2Table() */
       static const uint16_t ZERO_OFFSET;
 };
 
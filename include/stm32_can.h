@@ -45,6 +45,7 @@ public:
    void Send(uint32_t canId, uint32_t data[2], uint8_t len);
    void SendAll();
    void SDOWrite(uint8_t remoteNodeId, uint16_t index, uint8_t subIndex, uint32_t data);
+   void SendEmcy(uint16_t errorCode, uint8_t errorRegister, const uint8_t manufacturer[5]);
    void Save();
    void SetReceiveCallback(void (*recv)(uint32_t, uint32_t*));
    bool RegisterUserMessage(int canId);
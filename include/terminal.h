@@ -73,7 +73,7 @@ private:
    uint8_t curBuf;
    uint32_t curIdx;
    bool firstSend;
-   char inBuf[bufSize];
+   char inBuf[bufSize + 1]; //+1 for terminating a completely filled buffer
    char outBuf[2][bufSize]; //double buffering
    char args[bufSize];
 };
@@ -32,10 +32,12 @@ class TerminalCommands
       static void SaveParameters(Terminal* term, char *arg);
       static void LoadParameters(Terminal* term, char *arg);
       static void Reset(Terminal* term, char *arg);
+      static void PrintHistory(Terminal* term, char *arg);
 
    protected:
 
    private:
+      static void PrintValue(Terminal* term, Param::PARAM_NUM param, int32_t raw);
       static void PrintCanMap(Param::PARAM_NUM param, int canid, int offset, int length, s32fp gain, bool rx);
 };
 
@@ -0,0 +1,136 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include "acimmodel.h"
+
+/* Not FRAC_FAC, that follows CST_DIGITS of the including file */
+#define FP_SCALE ((float)(1 << FRAC_DIGITS))
+
+const float AcimModel::TWO_PI = 6.283185307f;
+
+AcimModel::AcimModel()
+ : rs(0.5f), rr(0.4f), lm(0.05f), ls(0.052f), lr(0.052f), polePairs(2),
+   inertia(0), friction(0), loadTorque(0), dt(1e-4f), subSteps(1), pwmRange(65536),
+   ialpha(0), ibeta(0), fluxAlpha(0), fluxBeta(0), angle(0), omega(0), torque(0), idc(0)
+{
+}
+
+void AcimModel::SetElectricalParameters(float rs, float rr, float lm, float lsl, float lrl, int polePairs)
+{
+   this->rs = rs;
+   this->rr = rr;
+   this->lm = lm;
+   ls = lm + lsl;
+   lr = lm + lrl;
+   this->polePairs = polePairs;
+}
+
+void AcimModel::SetMechanicalParameters(float inertia, float friction)
+{
+   this->inertia = inertia;
+   this->friction = friction;
+}
+
+void AcimModel::SetCallingFrequency(int frequency, int subSteps)
+{
+   this->subSteps = subSteps > 0 ? subSteps : 1;
+   dt = 1.0f / (frequency * this->subSteps);
+}
+
+void AcimModel::SetSpeed(float rpm)
+{
+   omega = rpm * polePairs * TWO_PI / 60.0f;
+}
+
+float AcimModel::GetSpeed()
+{
+   return omega * 60.0f / (TWO_PI * polePairs);
+}
+
+s32fp AcimModel::GetIl1()
+{
+   return (s32fp)(ialpha * FP_SCALE);
+}
+
+s32fp AcimModel::GetIl2()
+{
+   return (s32fp)((-0.5f * ialpha + 0.866025404f * ibeta) * FP_SCALE);
+}
+
+uint16_t AcimModel::GetFluxAngle()
+{
+   return (uint16_t)(int32_t)(atan2f(fluxBeta, fluxAlpha) * (65536.0f / TWO_PI));
+}
+
+float AcimModel::GetFlux()
+{
+   return sqrtf(fluxAlpha * fluxAlpha + fluxBeta * fluxBeta);
+}
+
+float AcimModel::GetId()
+{
+   float flux = GetFlux();
+   return flux > 0 ? (ialpha * fluxAlpha + ibeta * fluxBeta) / flux : 0;
+}
+
+float AcimModel::GetIq()
+{
+   float flux = GetFlux();
+   return flux > 0 ? (ibeta * fluxAlpha - ialpha * fluxBeta) / flux : 0;
+}
+
+void AcimModel::Step(const int32_t* dutyCycles, s32fp udc)
+{
+   float u = udc / (FP_SCALE * pwmRange);
+   float d1 = dutyCycles[0], d2 = dutyCycles[1], d3 = dutyCycles[2];
+   float common = (d1 + d2 + d3) / 3;
+   float ualpha = (d1 - common) * u;
+   float ubeta = (d2 - d3) * u * 0.577350269f;
+   float tr = lr / rr;
+   float kr = lm / lr;
+   float sigmaLs = ls - lm * kr;
+
+   for (int i = 0; i < subSteps; i++)
+   {
+      //Rotor flux first, the stator equation uses its derivative
+      float dFluxAlpha = (lm * ialpha - fluxAlpha) / tr - omega * fluxBeta;
+      float dFluxBeta = (lm * ibeta - fluxBeta) / tr + omega * fluxAlpha;
+
+      fluxAlpha += dt * dFluxAlpha;
+      fluxBeta += dt * dFluxBeta;
+      ialpha += dt * (ualpha - rs * ialpha - kr * dFluxAlpha) / sigmaLs;
+      ibeta += dt * (ubeta - rs * ibeta - kr * dFluxBeta) / sigmaLs;
+
+      torque = 1.5f * polePairs * kr * (fluxAlpha * ibeta - fluxBeta * ialpha);
+
+      if (inertia > 0)
+      {
+         float omegaMech = omega / polePairs;
+         omegaMech += dt * (torque - loadTorque - friction * omegaMech) / inertia;
+         omega = omegaMech * polePairs;
+      }
+
+      angle += omega * dt;
+      if (angle >= TWO_PI) angle -= TWO_PI;
+      else if (angle < 0) angle += TWO_PI;
+
+      //Power balance, inverter losses neglected
+      idc = u > 0 ? 1.5f * (ualpha * ialpha + ubeta * ibeta) / (u * pwmRange) : 0;
+   }
+}
@@ -18,13 +18,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <libopencm3/stm32/gpio.h>
-#include <libopencm3/stm32/dma.h>
-#include <libopencm3/stm32/adc.h>
+#include "hal_gpio.h"
+#include "hal_adc.h"
 #include "anain.h"
 #include "my_math.h"
 
-#define ADC_DMA_CHAN 1
 #define MEDIAN3_FROM_ADC_ARRAY(a) median3(*a, *(a + ANA_IN_COUNT), *(a + 2*ANA_IN_COUNT))
 
 uint8_t AnaIn::channel_array[ANA_IN_COUNT];
@@ -40,38 +38,12 @@ ANA_IN_LIST
 */
 void AnaIn::Start()
 {
-   adc_power_off(ADC1);
-   adc_enable_scan_mode(ADC1);
-   adc_set_continuous_conversion_mode(ADC1);
-   adc_set_right_aligned(ADC1);
-   adc_set_sample_time_on_all_channels(ADC1, SAMPLE_TIME);
-
-   adc_power_on(ADC1);
-   /* wait for adc starting up*/
-   for (volatile int i = 0; i < 80000; i++);
-
-   adc_reset_calibration(ADC1);
-   adc_calibrate(ADC1);
-
-   adc_set_regular_sequence(ADC1, ANA_IN_COUNT, channel_array);
-   adc_enable_dma(ADC1);
-
-   dma_set_peripheral_address(DMA1, ADC_DMA_CHAN, (uint32_t)&ADC_DR(ADC1));
-   dma_set_memory_address(DMA1, ADC_DMA_CHAN, (uint32_t)values);
-   dma_set_peripheral_size(DMA1, ADC_DMA_CHAN, DMA_CCR_PSIZE_16BIT);
-   dma_set_memory_size(DMA1, ADC_DMA_CHAN, DMA_CCR_MSIZE_16BIT);
-   dma_set_number_of_data(DMA1, ADC_DMA_CHAN, NUM_SAMPLES * ANA_IN_COUNT);
-   dma_enable_memory_increment_mode(DMA1, ADC_DMA_CHAN);
-   dma_enable_circular_mode(DMA1, ADC_DMA_CHAN);
-   dma_enable_channel(DMA1, ADC_DMA_CHAN);
-
-   adc_start_conversion_regular(ADC1);
-   adc_start_conversion_direct(ADC1);
+   hal_adc_start(channel_array, ANA_IN_COUNT, values, NUM_SAMPLES * ANA_IN_COUNT, SAMPLE_TIME);
 }
 
 void AnaIn::Configure(uint32_t port, uint8_t pin)
 {
-   gpio_set_mode(port, GPIO_MODE_INPUT, GPIO_CNF_INPUT_ANALOG, 1 << pin);
+   hal_gpio_set_mode(port, GPIO_MODE_INPUT, GPIO_CNF_INPUT_ANALOG, 1 << pin);
    channel_array[GetIndex()] = AdcChFromPort(port, pin);
 }
 
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "anglepll.h"
+#include "sine_core.h"
+
+/* SineCore table values have 15 fractional digits */
+#define SINE_DIGITS 15
+
+AnglePll::AnglePll()
+ : kp(0), ki(0), extrapolationShift(0), angle(0), sampleAngle(0), speed(0), speedIntegral(0)
+{
+}
+
+uint16_t AnglePll::Update(int32_t sin, int32_t cos)
+{
+   //Predict from the last sample, extrapolated steps might not add up exactly
+   angle = sampleAngle + speed;
+   sampleAngle = angle;
+
+   uint16_t estimate = angle >> 16;
+   int32_t err = (sin * SineCore::Cosine(estimate) - cos * SineCore::Sine(estimate)) >> SINE_DIGITS;
+
+   speedIntegral += err * ki;
+   speed = speedIntegral + err * kp;
+
+   return angle >> 16;
+}
+
+uint16_t AnglePll::Extrapolate()
+{
+   angle += speed >> extrapolationShift;
+   return angle >> 16;
+}
+
+s32fp AnglePll::GetFrequency(int sampleFrequency)
+{
+   return ((int64_t)speed * sampleFrequency) >> (32 - FRAC_DIGITS);
+}
+
+void AnglePll::Reset(uint16_t initialAngle)
+{
+   angle = (uint32_t)initialAngle << 16;
+   sampleAngle = angle;
+   speed = 0;
+   speedIntegral = 0;
+}
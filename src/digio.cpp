@@ -57,10 +57,10 @@ void DigIo::Configure(uint32_t port, uint16_t pin, PinMode::PinMode pinMode)
          break;
    }
 
-   gpio_set_mode(port, mode, cnf, pin);
+   hal_gpio_set_mode(port, mode, cnf, pin);
    if (DIG_IO_ON == val)
    {
-      gpio_set(port, pin);
+      hal_gpio_set(port, pin);
    }
 }
 
@@ -19,11 +19,21 @@
 #include "errormessage.h"
 #include "printf.h"
 #include "my_string.h"
+#include "stm32_can.h"
+#include "hal_system.h"
+
+#define EMCY_GENERIC          0x1000
+#define EMCY_ERRREG_GENERIC   0x01
+#define EMCY_ERRREG_CURRENT   0x02
+#define EMCY_ERRREG_VOLTAGE   0x04
+#define EMCY_ERRREG_TEMP      0x08
+#define EMCY_ERRREG_COMM      0x10
 
 struct ErrorDescriptor
 {
    const char* msg;
    ERROR_TYPE type;
+   uint16_t emcyCode;
 };
 
 struct BufferEntry
@@ -32,18 +42,24 @@ struct BufferEntry
    uint32_t time;
 };
 
-#define ERROR_MESSAGE_ENTRY(id, type) { #id, type },
+#define ERROR_MESSAGE_ENTRY(id, type) { #id, type, EMCY_GENERIC },
+#define ERROR_EMCY_ENTRY(id, type, emcyCode) { #id, type, emcyCode },
 static const struct ErrorDescriptor errorDescriptors[] =
 {
-   { "", ERROR_LAST },
+   { "", ERROR_LAST, 0 },
    ERROR_MESSAGE_LIST
 };
 #undef ERROR_MESSAGE_ENTRY
+#undef ERROR_EMCY_ENTRY
 
 #define EXPANDED_LIST ERROR_MESSAGE_ENTRY(NONE, ERROR_DISPLAY) ERROR_MESSAGE_LIST
 #define ERROR_MESSAGE_ENTRY(id, type) __COUNTER__=id,
+#define ERROR_EMCY_ENTRY(id, type, emcyCode) __COUNTER__=id,
 const char* errorListString = STRINGIFY(EXPANDED_LIST);
 #undef ERROR_MESSAGE_ENTRY
+#undef ERROR_EMCY_ENTRY
+
+static_assert(ERROR_MESSAGE_LAST <= 256, "Error numbers must fit in one byte of the EMCY frame");
 
 static const char* types[ERROR_LAST] =
 {
@@ -59,17 +75,45 @@ uint32_t ErrorMessage::currentBufIdx = 0;
 uint32_t ErrorMessage::lastPrintIdx = 0;
 ERROR_MESSAGE_NUM ErrorMessage::lastError = ERROR_NONE;
 bool ErrorMessage::posted[ERROR_MESSAGE_LAST] = { false };
+Can* ErrorMessage::emcyCan = 0;
+uint32_t ErrorMessage::emcyInterval = 0;
+uint32_t ErrorMessage::lastEmcyTime[ERROR_MESSAGE_LAST] = { 0 };
+uint32_t ErrorMessage::pendingEmcyTime[ERROR_MESSAGE_LAST] = { 0 };
+bool ErrorMessage::emcySent[ERROR_MESSAGE_LAST] = { false };
+bool ErrorMessage::emcyPending[ERROR_MESSAGE_LAST] = { false };
+volatile uint32_t ErrorMessage::pendingEmcyCount = 0;
 
-/** Set timestamp for error message
+/** Set timestamp for error message.
+* Also sends EMCY frames that were held back by the minimum interval once it has passed
 * @param time Current timestamp, will be displayed as is in message */
 void ErrorMessage::SetTime(uint32_t time)
 {
    timeTick = time;
+
+   if (0 == pendingEmcyCount) return;
+
+   for (int i = 0; i < ERROR_MESSAGE_LAST; i++)
+   {
+      if (emcyPending[i] && (time - lastEmcyTime[i]) >= emcyInterval)
+      {
+         //Post() may be called from an interrupt, take the entry atomically
+         uint32_t irqMask = hal_irq_mask(1);
+         bool pending = emcyPending[i];
+         uint32_t postTime = pendingEmcyTime[i];
+
+         emcyPending[i] = false;
+         if (pending) pendingEmcyCount--;
+         hal_irq_mask(irqMask);
+
+         if (pending) SendEmcy(postTime, (ERROR_MESSAGE_NUM)i);
+      }
+   }
 }
 
 /** Post an error message.
  Every message can only be posted once, then UnpostAll() must be called to post it again
  @post Message is displayed and written to error memory
+ @post If a CAN interface is set, an EMCY frame is sent immediately
  @param msg message number */
 void ErrorMessage::Post(ERROR_MESSAGE_NUM msg)
 {
@@ -80,9 +124,23 @@ void ErrorMessage::Post(ERROR_MESSAGE_NUM msg)
       errorBuffer[currentBufIdx].time = timeTick;
       posted[msg] = true;
       currentBufIdx = (currentBufIdx + 1) % ERROR_BUF_SIZE;
+      SendEmcy(timeTick, msg);
    }
 }
 
+/** Send a CiA 301 EMCY frame for every newly posted error.
+ The same error is sent at most once per minInterval, so errors that are
+ re-posted after every UnpostAll() don't flood the bus. A post within the
+ interval is held back and sent by SetTime() when the interval has passed,
+ posts in between are merged into that frame.
+ @param can CAN interface to send EMCY frames on, 0 to disable
+ @param minInterval minimum time between two frames of the same error in SetTime() units */
+void ErrorMessage::SetCanInterface(Can* can, uint32_t minInterval)
+{
+   emcyCan = can;
+   emcyInterval = minInterval;
+}
+
 /** Unpost all error message, i.e. make them postable again.
  Does not reset the error buffer */
 void ErrorMessage::UnpostAll()
@@ -119,6 +177,46 @@ void ErrorMessage::PrintAllErrors()
       PrintError(errorBuffer[i].time, errorBuffer[i].msg);
 }
 
+/** Send EMCY frame with the errors CiA 301 code. The manufacturer specific
+ bytes contain our error number, the error type and bits 0-23 of the time */
+void ErrorMessage::SendEmcy(uint32_t time, ERROR_MESSAGE_NUM msg)
+{
+   if (0 == emcyCan) return;
+   if (emcySent[msg] && (timeTick - lastEmcyTime[msg]) < emcyInterval)
+   {
+      uint32_t irqMask = hal_irq_mask(1);
+
+      if (!emcyPending[msg])
+      {
+         emcyPending[msg] = true;
+         pendingEmcyTime[msg] = time;
+         pendingEmcyCount++;
+      }
+      hal_irq_mask(irqMask);
+      return;
+   }
+
+   uint16_t code = errorDescriptors[msg].emcyCode;
+   uint8_t errorRegister = EMCY_ERRREG_GENERIC;
+   uint8_t manufacturer[5] = { (uint8_t)msg, (uint8_t)errorDescriptors[msg].type,
+                               (uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16) };
+
+   //The generic bit is set for every error, plus the bit of the codes class
+   switch (code & 0xF000)
+   {
+      case 0x2000: errorRegister |= EMCY_ERRREG_CURRENT; break;
+      case 0x3000: errorRegister |= EMCY_ERRREG_VOLTAGE; break;
+      case 0x4000: errorRegister |= EMCY_ERRREG_TEMP; break;
+      case 0x8000:
+         if ((code & 0xFF00) == 0x8100) errorRegister |= EMCY_ERRREG_COMM;
+         break;
+   }
+
+   lastEmcyTime[msg] = timeTick;
+   emcySent[msg] = true;
+   emcyCan->SendEmcy(code, errorRegister, manufacturer);
+}
+
 void ErrorMessage::PrintError(uint32_t time, ERROR_MESSAGE_NUM msg)
 {
    printf("[%u]: %s - %s\r\n", time, types[errorDescriptors[msg].type], errorDescriptors[msg].msg);
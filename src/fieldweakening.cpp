@@ -0,0 +1,60 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fieldweakening.h"
+#include "my_math.h"
+
+FieldWeakening::FieldWeakening(FocChannel& foc)
+ : foc(foc), maxModPow2(0), halfMaxModRecip(0), maxCurrent(0), idfw(0), mtpa(false)
+{
+   controller.SetMinMaxY(0, 0);
+}
+
+void FieldWeakening::SetMaxModulation(int32_t maxMod)
+{
+   maxModPow2 = maxMod * maxMod;
+   halfMaxModRecip = maxMod > 0 ? (1U << 31) / maxMod : 0;
+   controller.SetRef(maxMod);
+}
+
+void FieldWeakening::SetCurrentLimits(int32_t maxCurrent, int32_t minId)
+{
+   this->maxCurrent = maxCurrent;
+   controller.SetMinMaxY(MAX(minId, -maxCurrent), 0);
+}
+
+void FieldWeakening::Run(int32_t is, int32_t ud, int32_t uq, int32_t& idref, int32_t& iqref)
+{
+   is = MAX(MIN(is, maxCurrent), -maxCurrent);
+
+   int32_t idMtpa = mtpa ? foc.MtpaId(is) : 0;
+
+   //Tangent of |u|² at the limit, (limit² + |u|²) / (2 * limit)
+   uint32_t magPow2 = (uint32_t)(ud * ud) + (uint32_t)(uq * uq);
+   int32_t magnitude = (((uint64_t)maxModPow2 + magPow2) * halfMaxModRecip) >> 32;
+
+   idfw = controller.Run(magnitude);
+   idref = MIN(idMtpa, idfw);
+
+   //min(sqrt(a), sqrt(b)) = sqrt(min(a, b)), MTPA iq and current circle share one root
+   int32_t isPow2 = is * is;
+   int32_t iqPow2 = MIN(isPow2 - idMtpa * idMtpa, maxCurrent * maxCurrent - idref * idref);
+   int32_t iq = iqPow2 == isPow2 ? ABS(is) : FocChannel::sqrt(MAX(iqPow2, 0));
+
+   iqref = is < 0 ? -iq : iq;
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fluxobserver.h"
+#include "sine_core.h"
+
+/* SineCore table values and FOC modulation indexes have 15 fractional digits */
+#define SINE_DIGITS   15
+#define FLUX_DIGITS   20
+#define RES_DIGITS    16
+#define IND_DIGITS    24
+#define DT_DIGITS     31
+#define GAIN_DIGITS   8
+#define PLL_AMPLITUDE 2048
+
+static const int32_t sqrt3inv1 = 18919; //1/sqrt(3) with 15 fractional digits
+
+FluxObserver::FluxObserver()
+ : fluxAlpha(0), fluxBeta(0), resistance(0), inductance(0), fluxLinkage(0), fluxLinkagePow2(0),
+   dtFactor(0), correctionGain(0), pllScale(0), frequency(1)
+{
+}
+
+void FluxObserver::SetMotorParameters(int32_t resistance, int32_t inductance, int32_t fluxLinkage)
+{
+   this->resistance = ((int64_t)resistance << RES_DIGITS) / 1000;
+   this->inductance = ((int64_t)inductance << IND_DIGITS) / 1000000;
+   this->fluxLinkage = ((int64_t)fluxLinkage << FLUX_DIGITS) / 1000000;
+   fluxLinkagePow2 = ((int64_t)this->fluxLinkage * this->fluxLinkage) >> FLUX_DIGITS;
+   pllScale = this->fluxLinkage > 0 ? (PLL_AMPLITUDE << 16) / this->fluxLinkage : 0;
+}
+
+void FluxObserver::SetCallingFrequency(int frequency)
+{
+   this->frequency = frequency;
+   dtFactor = (1U << DT_DIGITS) / frequency;
+}
+
+void FluxObserver::SetConvergenceRate(int32_t rate)
+{
+   int64_t divisor = (int64_t)frequency * fluxLinkagePow2;
+
+   if (divisor > 0)
+      correctionGain = ((int64_t)rate << (FLUX_DIGITS + GAIN_DIGITS)) / divisor;
+   else
+      correctionGain = 0;
+}
+
+/** \brief Run observer
+ *
+ * Flux is integrated as
+ * psi' = u - R * i + k * eta * (lambda^2 - |eta|^2)
+ * eta  = psi - L * i
+ * The correction term only acts radially so it does not bias the angle.
+ */
+uint16_t FluxObserver::Update(s32fp il1, s32fp il2, int32_t ud, int32_t uq, uint16_t angle, s32fp udc)
+{
+   int32_t sin = SineCore::Sine(angle);
+   int32_t cos = SineCore::Cosine(angle);
+
+   //Same transformations as FocChannel::ParkClarke() and InvParkClarke()
+   s32fp ia = il1;
+   s32fp ib = ((il1 + 2 * il2) * sqrt3inv1) >> SINE_DIGITS;
+   int32_t ma = (cos * ud - sin * uq) >> SINE_DIGITS;
+   int32_t mb = (cos * uq + sin * ud) >> SINE_DIGITS;
+   //Full duty cycle range 2^16 maps to udc
+   s32fp ua = ((int64_t)ma * udc) >> 16;
+   s32fp ub = ((int64_t)mb * udc) >> 16;
+
+   s32fp emfa = ua - (s32fp)(((int64_t)resistance * ia) >> RES_DIGITS);
+   s32fp emfb = ub - (s32fp)(((int64_t)resistance * ib) >> RES_DIGITS);
+
+   fluxAlpha += ((int64_t)emfa * dtFactor) >> (DT_DIGITS + FRAC_DIGITS - FLUX_DIGITS);
+   fluxBeta += ((int64_t)emfb * dtFactor) >> (DT_DIGITS + FRAC_DIGITS - FLUX_DIGITS);
+
+   int32_t etaa = fluxAlpha - (int32_t)(((int64_t)inductance * ia) >> (IND_DIGITS + FRAC_DIGITS - FLUX_DIGITS));
+   int32_t etab = fluxBeta - (int32_t)(((int64_t)inductance * ib) >> (IND_DIGITS + FRAC_DIGITS - FLUX_DIGITS));
+   int32_t magPow2 = ((int64_t)etaa * etaa + (int64_t)etab * etab) >> FLUX_DIGITS;
+   int64_t magErr = (int64_t)(fluxLinkagePow2 - magPow2) * correctionGain;
+
+   fluxAlpha += (etaa * magErr) >> (FLUX_DIGITS + GAIN_DIGITS);
+   fluxBeta += (etab * magErr) >> (FLUX_DIGITS + GAIN_DIGITS);
+
+   //Rotor flux points in d direction, normalize it so PLL gains are motor independent
+   int32_t pllCos = ((int64_t)etaa * pllScale) >> 16;
+   int32_t pllSin = ((int64_t)etab * pllScale) >> 16;
+
+   return pll.Update(pllSin, pllCos);
+}
+
+void FluxObserver::Reset(uint16_t angle)
+{
+   fluxAlpha = ((int64_t)fluxLinkage * SineCore::Cosine(angle)) >> SINE_DIGITS;
+   fluxBeta = ((int64_t)fluxLinkage * SineCore::Sine(angle)) >> SINE_DIGITS;
+   pll.Reset(angle);
+}
@@ -30,27 +30,49 @@
 #define S3 FP_FROMFLT(1)
 #define RADSTART(x) x < R1 ? S1 : (x < R2 ? S2 : S3)
 
-static const s32fp fluxLinkage = FP_FROMFLT(0.09);
-static const s32fp fluxLinkage2 = FP_MUL(fluxLinkage, fluxLinkage);
-static const s32fp lqminusldSquaredBs10 = FP_FROMFLT(0.01722); //additional 10-bit left shift because otherwise it can't be represented
-static const s32fp lqminusld = FP_FROMFLT(0.0058);
+static const s32fp defaultFluxLinkage = FP_FROMFLT(0.09);
+static const s32fp defaultLqminusld = FP_FROMFLT(0.0058);
 static const u32fp sqrt3 = SQRT3;
 static const s32fp sqrt3inv1 = FP_FROMFLT(0.57735026919); //1/sqrt(3)
 static const s32fp zeroOffset = FP_FROMINT(1);
 static const int32_t modMax = FP_DIV(FP_FROMINT(2U), sqrt3);
 static const int32_t modMaxPow2 = modMax * modMax;
+//Fundamental of six-step operation is 4/pi, overmodulation moves towards it starting at 1.2
+static const int32_t sixStepMod = FP_FROMFLT(1.2732395447);
+static const uint32_t sixStepModPow2 = sixStepMod * sixStepMod;
+static const uint32_t ovmRegion2Pow2 = FP_FROMFLT(1.2) * FP_FROMFLT(1.2);
+static const uint32_t ovmRegion2Recip = (1ULL << 47) / (sixStepModPow2 - ovmRegion2Pow2);
+static const int32_t vertexMax = FP_FROMINT(4) / 3; //six-step phase voltages
+static const int32_t vertexMin = FP_FROMINT(2) / 3;
 static const int32_t minPulse = 1000;
 static const int32_t maxPulse = FP_FROMINT(2) - 1000;
 
-s32fp FOC::id;
-s32fp FOC::iq;
-s32fp FOC::DutyCycles[3];
+FocChannel FOC::defaultChannel;
+s32fp& FOC::id = FOC::defaultChannel.id;
+s32fp& FOC::iq = FOC::defaultChannel.iq;
+int32_t (&FOC::DutyCycles)[3] = FOC::defaultChannel.DutyCycles;
+
+FocChannel::FocChannel()
+ : id(0), iq(0), pwmMode(PwmMode::SVPWM), overmodulation(false), dtBand(0), dtGain(0)
+{
+   DutyCycles[0] = DutyCycles[1] = DutyCycles[2] = 0;
+   SetMotorConstants(defaultFluxLinkage, defaultLqminusld);
+}
+
+void FocChannel::SetMotorConstants(s32fp fluxLinkage, s32fp lqminusld)
+{
+   this->fluxLinkage = fluxLinkage;
+   this->lqminusld = lqminusld;
+   fluxLinkage2 = FP_MUL(fluxLinkage, fluxLinkage);
+   //(Lq - Ld)^2 with additional 9-bit left shift because otherwise it can't be represented
+   lqminusldSquaredBs10 = ((int64_t)lqminusld * lqminusld) >> (CST_DIGITS - 9);
+}
 
 /** @brief Transform current to rotor system using Clarke and Park transformation
   * @post flux producing (id) and torque producing (iq) current are written
-  *       to FOC::id and FOC::iq
+  *       to id and iq
   */
-void FOC::ParkClarke(s32fp il1, s32fp il2, uint16_t angle)
+void FocChannel::ParkClarke(s32fp il1, s32fp il2, uint16_t angle)
 {
    s32fp sin = SineCore::Sine(angle);
    s32fp cos = SineCore::Cosine(angle);
@@ -70,18 +92,40 @@ void FOC::ParkClarke(s32fp il1, s32fp il2, uint16_t angle)
  * \return void
  *
  */
-void FOC::Mtpa(int32_t is, int32_t& idref, int32_t& iqref)
+void FocChannel::Mtpa(int32_t is, int32_t& idref, int32_t& iqref)
 {
-   int32_t isSquared = is * is;
    int32_t sign = is < 0 ? -1 : 1;
-   s32fp term1 = fpsqrt(fluxLinkage2 + ((lqminusldSquaredBs10 * isSquared) >> 10));
-   idref = FP_TOINT(FP_DIV(fluxLinkage - term1, lqminusld));
-   iqref = sign * (int32_t)sqrt(isSquared - idref * idref);
+   idref = MtpaId(is);
+   iqref = sign * (int32_t)sqrt(is * is - idref * idref);
 }
 
-int32_t FOC::GetQLimit(int32_t ud)
+/** \brief d current of the MTPA distribution, for callers that derive iq themselves
+ *
+ * \param is int32_t total motor current
+ * \return int32_t direct current reference
+ *
+ */
+int32_t FocChannel::MtpaId(int32_t is)
 {
-   return sqrt(modMaxPow2 - ud * ud);
+   s32fp term1 = fpsqrt(fluxLinkage2 + ((lqminusldSquaredBs10 * is * is) >> 10));
+   return FP_TOINT(FP_DIV(fluxLinkage - term1, lqminusld));
+}
+
+/** \brief Enable dead time compensation based on id and iq of the last ParkClarke() call
+ *
+ * \param comp duty cycle correction at large currents, 0 disables compensation
+ * \param band current below which the correction is reduced linearly, avoids
+ *        chattering around current zero crossings. Same scale as id and iq
+ */
+void FocChannel::SetDeadTimeCompensation(int32_t comp, s32fp band)
+{
+   dtBand = band;
+   dtGain = SineCore::CalcDeadTimeGain(comp, band);
+}
+
+int32_t FocChannel::GetQLimit(int32_t ud)
+{
+   return sqrt((overmodulation ? sixStepModPow2 : modMaxPow2) - ud * ud);
 }
 
 /** \brief Returns the resulting modulation index from uq and ud
@@ -91,7 +135,7 @@ int32_t FOC::GetQLimit(int32_t ud)
  * \return sqrt(ud²+uq²)
  *
  */
-int32_t FOC::GetTotalVoltage(int32_t ud, int32_t uq)
+int32_t FocChannel::GetTotalVoltage(int32_t ud, int32_t uq)
 {
    return sqrt((uint32_t)(ud * ud) + (uint32_t)(uq * uq));
 }
@@ -104,7 +148,7 @@ int32_t FOC::GetTotalVoltage(int32_t ud, int32_t uq)
  * \return void
  *
  */
-void FOC::InvParkClarke(int32_t ud, int32_t uq, uint16_t angle)
+void FocChannel::InvParkClarke(int32_t ud, int32_t uq, uint16_t angle)
 {
    s32fp sin = SineCore::Sine(angle);
    s32fp cos = SineCore::Cosine(angle);
@@ -112,12 +156,31 @@ void FOC::InvParkClarke(int32_t ud, int32_t uq, uint16_t angle)
    //Inverse Park transformation
    s32fp ua = (cos * ud - sin * uq) >> CST_DIGITS;
    s32fp ub = (cos * uq + sin * ud) >> CST_DIGITS;
-   //Inverse Clarke transformation
+   //Inverse Clarke transformation, 64 bit product because ub exceeds 1.15 in overmodulation
+   s32fp sqrt3ub = ((int64_t)SQRT3 * ub) >> CST_DIGITS;
    DutyCycles[0] = ua;
-   DutyCycles[1] = (-ua + FP_MUL(SQRT3, ub)) / 2;
-   DutyCycles[2] = (-ua - FP_MUL(SQRT3, ub)) / 2;
+   DutyCycles[1] = (-ua + sqrt3ub) / 2;
+   DutyCycles[2] = (-ua - sqrt3ub) / 2;
 
-   int32_t offset = SineCore::CalcSVPWMOffset(DutyCycles[0], DutyCycles[1], DutyCycles[2]);
+   if (overmodulation)
+   {
+      uint32_t magnitudePow2 = (uint32_t)(ud * ud) + (uint32_t)(uq * uq);
+
+      if (magnitudePow2 > (uint32_t)modMaxPow2)
+         Overmodulate(magnitudePow2);
+   }
+
+   int32_t offset = SineCore::CalcPWMOffset(DutyCycles[0], DutyCycles[1], DutyCycles[2], zeroOffset, pwmMode);
+
+   if (dtGain != 0)
+   {
+      //Phase currents from last measured id and iq at the new angle
+      s32fp ia = FP_MUL(cos, id) - FP_MUL(sin, iq);
+      s32fp sqrt3ib = FP_MUL(SQRT3, FP_MUL(cos, iq) + FP_MUL(sin, id));
+      DutyCycles[0] += SineCore::DeadTimeCompensation(ia, dtBand, dtGain);
+      DutyCycles[1] += SineCore::DeadTimeCompensation((-ia + sqrt3ib) / 2, dtBand, dtGain);
+      DutyCycles[2] += SineCore::DeadTimeCompensation((-ia - sqrt3ib) / 2, dtBand, dtGain);
+   }
 
    for (int i = 0; i < 3; i++)
    {
@@ -137,12 +200,59 @@ void FOC::InvParkClarke(int32_t ud, int32_t uq, uint16_t angle)
    }
 }
 
-int32_t FOC::GetMaximumModulationIndex()
+int32_t FocChannel::GetMaximumModulationIndex()
 {
-   return modMax;
+   return overmodulation ? sixStepMod : modMax;
+}
+
+/** \brief Limit phase voltages that exceed the linear range
+ *
+ * Region I: the vector is scaled onto the hexagon boundary, so unlike
+ * clipping each phase the angle is preserved.
+ * Region II (above 1.2): the vector is blended towards the nearest hexagon
+ * vertex, reaching six-step operation at 4/pi.
+ *
+ * \param magnitudePow2 ud² + uq² of the requested vector
+ */
+void FocChannel::Overmodulate(uint32_t magnitudePow2)
+{
+   int32_t maxVal = MAX(MAX(DutyCycles[0], DutyCycles[1]), DutyCycles[2]);
+   int32_t minVal = MIN(MIN(DutyCycles[0], DutyCycles[1]), DutyCycles[2]);
+   int32_t span = maxVal - minVal;
+
+   if (span > 2 * zeroOffset)
+   {
+      int32_t scale = ((int64_t)(2 * zeroOffset) << CST_DIGITS) / span;
+
+      for (int i = 0; i < 3; i++)
+         DutyCycles[i] = FP_MUL(DutyCycles[i], scale);
+   }
+
+   if (magnitudePow2 > ovmRegion2Pow2)
+   {
+      int32_t blend = FP_FROMINT(1);
+      int vertex = 0;
+      //The phase with the largest magnitude points to the nearest vertex
+      for (int i = 1; i < 3; i++)
+      {
+         if (ABS(DutyCycles[i]) > ABS(DutyCycles[vertex]))
+            vertex = i;
+      }
+
+      int32_t sign = DutyCycles[vertex] < 0 ? -1 : 1;
+
+      if (magnitudePow2 < sixStepModPow2)
+         blend = ((uint64_t)(magnitudePow2 - ovmRegion2Pow2) * ovmRegion2Recip) >> 32;
+
+      for (int i = 0; i < 3; i++)
+      {
+         int32_t target = sign * (i == vertex ? vertexMax : -vertexMin);
+         DutyCycles[i] += ((int64_t)blend * (target - DutyCycles[i])) >> CST_DIGITS;
+      }
+   }
 }
 
-uint32_t FOC::sqrt(uint32_t rad)
+uint32_t FocChannel::sqrt(uint32_t rad)
 {
    uint32_t radshift = (rad < 10000 ? 5 : (rad < 10000000 ? 9 : (rad < 1000000000 ? 13 : 15)));
    uint32_t sqrt = (rad >> radshift) + 1; //Starting value for newton iteration
@@ -156,7 +266,7 @@ uint32_t FOC::sqrt(uint32_t rad)
    return sqrt;
 }
 
-u32fp FOC::fpsqrt(u32fp rad)
+u32fp FocChannel::fpsqrt(u32fp rad)
 {
    u32fp sqrt = RADSTART(rad);
    u32fp sqrtl;
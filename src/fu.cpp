@@ -20,9 +20,13 @@
 #include "fu.h"
 
 uint32_t MotorVoltage::boost = 0;
-u32fp MotorVoltage::fac;
 uint32_t MotorVoltage::maxAmp;
 u32fp MotorVoltage::endFrq = 1; //avoid division by 0 when not set
+bool MotorVoltage::userCurve = false;
+int MotorVoltage::numSegments = 1;
+u32fp MotorVoltage::segFrq[MAX_POINTS];
+int32_t MotorVoltage::segAmp[MAX_POINTS];
+int32_t MotorVoltage::segSlope[MAX_POINTS];
 
 /** Set 0 Hz boost to overcome winding resistance */
 void MotorVoltage::SetBoost(uint32_t boost /**< amplitude in digit */)
@@ -38,21 +42,52 @@ void MotorVoltage::SetWeakeningFrq(u32fp frq)
    CalcFac();
 }
 
+/** Replace the linear u/f characteristic by a piecewise linear curve.
+ * Below the first and above the last point the outer segments are extrapolated,
+ * the result is always limited to the amplitude set with SetMaxAmp()
+ * @param frq numPoints frequencies in increasing order
+ * @param amp numPoints amplitudes in digit
+ * @param numPoints number of points, 2..MAX_POINTS. Less than 2 reverts to the
+ * linear curve defined by SetBoost() and SetWeakeningFrq()
+ */
+void MotorVoltage::SetCurve(const u32fp* frq, const uint32_t* amp, int numPoints)
+{
+   userCurve = numPoints >= 2;
+
+   if (userCurve)
+      CalcSegments(frq, amp, numPoints > MAX_POINTS ? MAX_POINTS : numPoints);
+   else
+      CalcFac();
+}
+
 /** Get amplitude for a given frequency */
 uint32_t MotorVoltage::GetAmp(u32fp frq)
 {
-   return MotorVoltage::GetAmpPerc(frq, FP_FROMINT(100));
+   int32_t amp = CalcAmp(frq);
+
+   if (frq < FP_FROMFLT(0.2) || amp < 0)
+   {
+      amp = 0;
+   }
+   if ((uint32_t)amp > maxAmp)
+   {
+      amp = maxAmp;
+   }
+
+   return amp;
 }
 
-/** Get amplitude for given frequency multiplied with given percentage */
+/** Get amplitude for given frequency multiplied with given percentage.
+ * The division by 100 is done by multiplying with its reciprocal, the result
+ * may be one digit below FP_MUL(perc, amp) / 100 */
 uint32_t MotorVoltage::GetAmpPerc(u32fp frq, u32fp perc)
 {
-   uint32_t amp = FP_MUL(perc, (FP_TOINT(FP_MUL(fac, frq)) + boost)) / 100;
-   if (frq < FP_FROMFLT(0.2))
+   int32_t amp = ((int64_t)perc * CalcAmp(frq) * PERC_RECIP) >> 32;
+   if (frq < FP_FROMFLT(0.2) || amp < 0)
    {
       amp = 0;
    }
-   if (amp > maxAmp)
+   if ((uint32_t)amp > maxAmp)
    {
       amp = maxAmp;
    }
@@ -69,5 +104,45 @@ void MotorVoltage::SetMaxAmp(uint32_t maxAmp)
 /** Calculate slope of u/f */
 void MotorVoltage::CalcFac()
 {
-   fac = FP_DIV(FP_FROMINT(maxAmp - boost), endFrq);
+   if (userCurve) return;
+
+   u32fp frq[] = { 0, endFrq };
+   uint32_t amp[] = { boost, maxAmp };
+   CalcSegments(frq, amp, 2);
+}
+
+/** Precompute start point and slope of every curve segment */
+void MotorVoltage::CalcSegments(const u32fp* frq, const uint32_t* amp, int numPoints)
+{
+   numSegments = numPoints - 1;
+
+   for (int i = 0; i < numSegments; i++)
+   {
+      segFrq[i] = frq[i];
+      segAmp[i] = amp[i];
+
+      if (frq[i + 1] > frq[i])
+         segSlope[i] = FP_DIV(FP_FROMINT((int32_t)(amp[i + 1] - amp[i])), (int32_t)(frq[i + 1] - frq[i]));
+      else
+         segSlope[i] = 0;
+   }
+}
+
+/** Evaluate curve without limiting.
+ * Binary search for the segment, so there is no state shared between callers */
+int32_t MotorVoltage::CalcAmp(u32fp frq)
+{
+   int i = 0, last = numSegments - 1;
+
+   while (i < last)
+   {
+      int mid = (i + last + 1) / 2;
+
+      if (frq >= segFrq[mid])
+         i = mid;
+      else
+         last = mid - 1;
+   }
+
+   return segAmp[i] + (int32_t)(((int64_t)segSlope[i] * (int32_t)(frq - segFrq[i])) >> (2 * CST_DIGITS));
 }
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gainscheduler.h"
+#include "my_math.h"
+#include "hal_system.h"
+
+#define INVDIST_BITS 30
+
+GainScheduler::GainScheduler(Param::PARAM_NUM firstParam, int numX, int numY)
+ : firstParam(firstParam), numX(MAX(MIN(numX, MAX_POINTS), 2)), numY(MAX(MIN(numY, MAX_POINTS), 1))
+{
+   LoadFromParams();
+}
+
+void GainScheduler::LoadFromParams()
+{
+   int param = firstParam;
+   int numEntries = numX * numY;
+
+   for (int i = 0; i < numX; i++, param++)
+      xPoints[i] = Param::Get((Param::PARAM_NUM)param);
+
+   //1D tables have no y breakpoint parameters
+   for (int i = 0; i < numY && numY > 1; i++, param++)
+      yPoints[i] = Param::Get((Param::PARAM_NUM)param);
+
+   for (int i = 0; i < numEntries; i++, param++)
+      kpTable[i] = Param::GetInt((Param::PARAM_NUM)param);
+
+   for (int i = 0; i < numEntries; i++, param++)
+      kiTable[i] = Param::GetInt((Param::PARAM_NUM)param);
+
+   //Guard against decreasing or equal breakpoints, the segment is then skipped
+   for (int i = 0; i < numX - 1; i++)
+      xInvDist[i] = (1 << INVDIST_BITS) / MAX(xPoints[i + 1] - xPoints[i], 1);
+
+   for (int i = 0; i < numY - 1; i++)
+      yInvDist[i] = (1 << INVDIST_BITS) / MAX(yPoints[i + 1] - yPoints[i], 1);
+}
+
+void GainScheduler::GetGains(s32fp x, s32fp y, int& kp, int& ki)
+{
+   int32_t fracX, fracY;
+   int ix = FindSegment(xPoints, xInvDist, numX, x, fracX);
+
+   if (numY > 1)
+   {
+      int iy = FindSegment(yPoints, yInvDist, numY, y, fracY);
+      int row0 = iy * numX + ix;
+      int row1 = row0 + numX;
+
+      kp = Interpolate(Interpolate(kpTable[row0], kpTable[row0 + 1], fracX),
+                       Interpolate(kpTable[row1], kpTable[row1 + 1], fracX), fracY);
+      ki = Interpolate(Interpolate(kiTable[row0], kiTable[row0 + 1], fracX),
+                       Interpolate(kiTable[row1], kiTable[row1 + 1], fracX), fracY);
+   }
+   else
+   {
+      kp = Interpolate(kpTable[ix], kpTable[ix + 1], fracX);
+      ki = Interpolate(kiTable[ix], kiTable[ix + 1], fracX);
+   }
+}
+
+void GainScheduler::Apply(PiController& ctrl, s32fp x, s32fp y)
+{
+   int kp, ki;
+
+   GetGains(x, y, kp, ki);
+   //SetGains() is two stores, don't let the control interrupt run in between
+   uint32_t irqMask = hal_irq_mask(1);
+   ctrl.SetGains(kp, ki);
+   hal_irq_mask(irqMask);
+}
+
+/** Find segment that contains val and its relative position within that segment
+ * \param points breakpoints
+ * \param invDist reciprocal breakpoint distances
+ * \param num number of breakpoints
+ * \param val value to look up
+ * \param[out] frac position within segment, 0..2^FRAC_BITS. Clamped outside the table
+ * \return index of lower breakpoint of segment
+ */
+int GainScheduler::FindSegment(const s32fp* points, const int32_t* invDist, int num, s32fp val, int32_t& frac)
+{
+   int i = 0;
+
+   for (; i < num - 2 && val >= points[i + 1]; i++);
+
+   if (val <= points[i])
+      frac = 0;
+   else if (val >= points[i + 1])
+      frac = 1 << FRAC_BITS;
+   else
+      frac = ((int64_t)(val - points[i]) * invDist[i]) >> (INVDIST_BITS - FRAC_BITS);
+
+   return i;
+}
+
+int GainScheduler::Interpolate(int a, int b, int32_t frac)
+{
+   return a + (int)(((int64_t)(b - a) * frac + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+}
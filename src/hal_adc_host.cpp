@@ -0,0 +1,63 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_adc.h"
+
+#define NUM_CHANNELS 18
+
+static uint16_t channelValues[NUM_CHANNELS];
+static uint8_t* sequence;
+static int sequenceLength;
+static uint16_t* dmaBuffer;
+static int dmaSize;
+static int dmaIndex;
+
+void hal_adc_start(uint8_t* channels, int numChannels, uint16_t* buffer, int bufferSize, uint8_t sampleTime)
+{
+   (void)sampleTime;
+   sequence = channels;
+   sequenceLength = numChannels;
+   dmaBuffer = buffer;
+   dmaSize = bufferSize;
+   dmaIndex = 0;
+}
+
+/** Set the value that subsequent conversions of channel return */
+void hal_adc_host_set(int channel, uint16_t value)
+{
+   assert(channel >= 0 && channel < NUM_CHANNELS);
+   channelValues[channel] = value;
+}
+
+/** Convert the regular sequence the given number of times, DMA wraps around like on the target */
+void hal_adc_host_convert(int sequences)
+{
+   assert(dmaBuffer != 0);
+
+   for (int s = 0; s < sequences; s++)
+   {
+      for (int i = 0; i < sequenceLength; i++)
+      {
+         dmaBuffer[dmaIndex] = channelValues[sequence[i]];
+         dmaIndex = (dmaIndex + 1) % dmaSize;
+      }
+   }
+}
+#endif // HOST_BUILD
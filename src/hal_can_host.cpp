@@ -0,0 +1,214 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_can.h"
+
+#define NUM_MAILBOXES   3
+#define FIFO_DEPTH      3
+#define NUM_FILTERBANKS 28
+#define CAN2_FIRST_BANK 14 //Reset value of CAN_FMR.CAN2SB
+
+struct Frame
+{
+   uint32_t id;
+   uint8_t len;
+   uint32_t data[2];
+};
+
+struct Fifo
+{
+   Frame frames[FIFO_DEPTH];
+   int count;
+};
+
+struct Interface
+{
+   uint32_t address;
+   bool initialized;
+   uint32_t btr;
+   bool rxIrq;
+   bool txIrq;
+   Frame mailboxes[NUM_MAILBOXES]; //In order of transmission
+   int pending;
+   Fifo fifos[2];
+};
+
+struct FilterBank
+{
+   uint16_t ids[HAL_CAN_FILTERS_PER_BANK];
+   int fifo;
+   bool active;
+};
+
+static Interface interfaces[] = { { CAN1, false, 0, false, false, { }, 0, { } },
+                                  { CAN2, false, 0, false, false, { }, 0, { } } };
+static FilterBank filterBanks[NUM_FILTERBANKS];
+
+static Interface& GetInterface(uint32_t can)
+{
+   assert(can == CAN1 || can == CAN2);
+   return interfaces[can == CAN1 ? 0 : 1];
+}
+
+static void CopyFrame(Frame& f, uint32_t id, uint8_t len, const uint32_t data[2])
+{
+   f.id = id;
+   f.len = len;
+   f.data[0] = data[0];
+   f.data[1] = data[1];
+}
+
+void hal_can_setup_pins(uint32_t can)
+{
+   GetInterface(can);
+}
+
+void hal_can_reset(uint32_t can)
+{
+   Interface& i = GetInterface(can);
+   uint32_t address = i.address;
+
+   i = Interface();
+   i.address = address;
+}
+
+void hal_can_init(uint32_t can, uint32_t ts1, uint32_t ts2, uint32_t prescaler)
+{
+   GetInterface(can).btr = ts1 | ts2 | (prescaler - 1);
+   GetInterface(can).initialized = true;
+}
+
+void hal_can_enable_rx_irq(uint32_t can)
+{
+   GetInterface(can).rxIrq = true;
+}
+
+void hal_can_enable_tx_irq(uint32_t can, bool enable)
+{
+   GetInterface(can).txIrq = enable;
+}
+
+int hal_can_transmit(uint32_t can, uint32_t id, uint8_t len, const uint32_t data[2])
+{
+   Interface& i = GetInterface(can);
+
+   if (i.pending == NUM_MAILBOXES) return -1;
+
+   CopyFrame(i.mailboxes[i.pending], id, len, data);
+   return i.pending++;
+}
+
+int hal_can_receive(uint32_t can, int fifo, uint32_t* id, uint8_t* len, uint32_t data[2])
+{
+   Fifo& f = GetInterface(can).fifos[fifo];
+
+   if (f.count == 0) return 0;
+
+   *id = f.frames[0].id;
+   *len = f.frames[0].len;
+   data[0] = f.frames[0].data[0];
+   data[1] = f.frames[0].data[1];
+
+   for (int i = 1; i < f.count; i++)
+      f.frames[i - 1] = f.frames[i];
+
+   f.count--;
+   return 1;
+}
+
+void hal_can_filter_id_list(int filterId, const uint16_t ids[HAL_CAN_FILTERS_PER_BANK], int fifo)
+{
+   assert(filterId >= 0 && filterId < NUM_FILTERBANKS);
+
+   for (int i = 0; i < HAL_CAN_FILTERS_PER_BANK; i++)
+      filterBanks[filterId].ids[i] = ids[i];
+
+   filterBanks[filterId].fifo = fifo;
+   filterBanks[filterId].active = true;
+}
+
+int hal_can_first_filter(uint32_t can)
+{
+   return can == CAN1 ? 0 : CAN2_FIRST_BANK;
+}
+
+/** @return number of messages waiting in the mailboxes */
+int hal_can_host_pending(uint32_t can)
+{
+   return GetInterface(can).pending;
+}
+
+/** Let the bus take the oldest pending message
+ * @return false if no message was pending */
+bool hal_can_host_transmit_complete(uint32_t can, uint32_t* id, uint8_t* len, uint32_t data[2])
+{
+   Interface& i = GetInterface(can);
+
+   if (i.pending == 0) return false;
+
+   *id = i.mailboxes[0].id;
+   *len = i.mailboxes[0].len;
+   data[0] = i.mailboxes[0].data[0];
+   data[1] = i.mailboxes[0].data[1];
+
+   for (int m = 1; m < i.pending; m++)
+      i.mailboxes[m - 1] = i.mailboxes[m];
+
+   i.pending--;
+   return true;
+}
+
+/** Put a message from the bus through the filters of can into a FIFO
+ * @return true if a filter matched and the FIFO was not full */
+bool hal_can_host_receive(uint32_t can, uint32_t id, uint8_t len, const uint32_t data[2])
+{
+   int first = hal_can_first_filter(can);
+   int last = can == CAN1 ? CAN2_FIRST_BANK : NUM_FILTERBANKS;
+
+   for (int b = first; b < last; b++)
+   {
+      if (!filterBanks[b].active) continue;
+
+      for (int i = 0; i < HAL_CAN_FILTERS_PER_BANK; i++)
+      {
+         if (filterBanks[b].ids[i] == id)
+         {
+            Fifo& f = GetInterface(can).fifos[filterBanks[b].fifo];
+
+            if (f.count == FIFO_DEPTH) return false; //Overrun
+
+            CopyFrame(f.frames[f.count++], id, len, data);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+bool hal_can_host_tx_irq_enabled(uint32_t can)
+{
+   return GetInterface(can).txIrq;
+}
+
+int hal_can_host_rx_pending(uint32_t can, int fifo)
+{
+   return GetInterface(can).fifos[fifo].count;
+}
+#endif // HOST_BUILD
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_flash.h"
+
+#define FLASH_WORDS (HOST_FLASH_SIZE / 4)
+
+static uint32_t flash[FLASH_WORDS];
+static bool flashErased = false;
+static bool flashLocked = true;
+static uint32_t crc = 0xFFFFFFFF;
+
+static uint32_t* FlashWord(uint32_t address)
+{
+   //Simulated flash starts out erased, as on a new chip
+   if (!flashErased)
+   {
+      for (uint32_t i = 0; i < FLASH_WORDS; i++)
+         flash[i] = 0xFFFFFFFF;
+      flashErased = true;
+   }
+   //Accessing outside the simulated flash would fault on the target as well
+   assert(address >= HOST_FLASH_BASE && (address - HOST_FLASH_BASE) / 4 < FLASH_WORDS);
+   return &flash[(address - HOST_FLASH_BASE) / 4];
+}
+
+void hal_flash_unlock(void)
+{
+   flashLocked = false;
+}
+
+void hal_flash_lock(void)
+{
+   flashLocked = true;
+}
+
+void hal_flash_set_ws(uint32_t waitStates)
+{
+   (void)waitStates;
+}
+
+void hal_flash_erase_page(uint32_t address)
+{
+   if (flashLocked) return;
+
+   uint32_t* page = FlashWord(address & ~(HOST_FLASH_PAGE_SIZE - 1));
+
+   for (uint32_t i = 0; i < HOST_FLASH_PAGE_SIZE / 4; i++)
+      page[i] = 0xFFFFFFFF;
+}
+
+/** Like real flash, programming can only clear bits */
+void hal_flash_program_word(uint32_t address, uint32_t data)
+{
+   if (flashLocked) return;
+
+   *FlashWord(address) &= data;
+}
+
+const uint32_t* hal_flash_pointer(uint32_t address)
+{
+   return FlashWord(address);
+}
+
+void hal_crc_reset(void)
+{
+   crc = 0xFFFFFFFF;
+}
+
+/** CRC-32 polynomial 0x04C11DB7, 32 bits at a time, MSB first, no output XOR */
+uint32_t hal_crc_calculate(uint32_t data)
+{
+   crc ^= data;
+
+   for (int i = 0; i < 32; i++)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+
+   return crc;
+}
+
+uint32_t hal_crc_calculate_block(const uint32_t* data, int size)
+{
+   for (int i = 0; i < size; i++)
+      hal_crc_calculate(data[i]);
+
+   return crc;
+}
+#endif // HOST_BUILD
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_gpio.h"
+
+#define NUM_PORTS 5
+
+struct Port
+{
+   uint8_t mode[16]; //MODE | CNF << 2 like the CRL/CRH nibbles
+   uint16_t idr;
+   uint16_t odr;
+};
+
+static Port ports[NUM_PORTS];
+
+static Port& GetPort(uint32_t port)
+{
+   uint32_t idx = (port - GPIOA) / (GPIOB - GPIOA);
+
+   assert(port >= GPIOA && idx < NUM_PORTS);
+   return ports[idx];
+}
+
+static uint16_t OutputMask(const Port& p)
+{
+   uint16_t mask = 0;
+
+   for (int i = 0; i < 16; i++)
+   {
+      if ((p.mode[i] & 3) != GPIO_MODE_INPUT)
+         mask |= 1 << i;
+   }
+   return mask;
+}
+
+void hal_gpio_set_mode(uint32_t port, uint8_t mode, uint8_t cnf, uint16_t pins)
+{
+   Port& p = GetPort(port);
+
+   for (int i = 0; i < 16; i++)
+   {
+      if (pins & (1 << i))
+         p.mode[i] = mode | (cnf << 2);
+   }
+}
+
+/** Output pins read back their output register, inputs the injected level */
+uint16_t hal_gpio_get(uint32_t port, uint16_t pins)
+{
+   Port& p = GetPort(port);
+   uint16_t outMask = OutputMask(p);
+
+   return ((p.idr & ~outMask) | (p.odr & outMask)) & pins;
+}
+
+void hal_gpio_set(uint32_t port, uint16_t pins)
+{
+   GetPort(port).odr |= pins;
+}
+
+void hal_gpio_clear(uint32_t port, uint16_t pins)
+{
+   GetPort(port).odr &= ~pins;
+}
+
+void hal_gpio_toggle(uint32_t port, uint16_t pins)
+{
+   GetPort(port).odr ^= pins;
+}
+
+void hal_gpio_host_set_input(uint32_t port, uint16_t pins, bool level)
+{
+   Port& p = GetPort(port);
+
+   if (level)
+      p.idr |= pins;
+   else
+      p.idr &= ~pins;
+}
+
+uint16_t hal_gpio_host_get_output(uint32_t port)
+{
+   return GetPort(port).odr;
+}
+
+/** @return MODE | CNF << 2 of the given pin number */
+uint8_t hal_gpio_host_get_mode(uint32_t port, int pin)
+{
+   return GetPort(port).mode[pin];
+}
+#endif // HOST_BUILD
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <time.h>
+#include "hal_system.h"
+
+static int resets = 0;
+static bool irqDisabled = false;
+static uint32_t rtc = 0;
+
+/** The target does not return from a reset, the simulation counts it and carries on */
+void hal_system_reset(void)
+{
+   resets++;
+}
+
+void hal_irq_disable(void)
+{
+   irqDisabled = true;
+}
+
+void hal_irq_enable(void)
+{
+   irqDisabled = false;
+}
+
+uint32_t hal_irq_mask(uint32_t mask)
+{
+   uint32_t old = irqDisabled;
+   irqDisabled = mask != 0;
+   return old;
+}
+
+uint32_t hal_rtc_get_counter(void)
+{
+   return rtc;
+}
+
+void hal_cycle_counter_enable(void)
+{
+}
+
+/** Nanoseconds of the monotonic clock, wraps like the 32 bit DWT counter */
+uint32_t hal_cycle_counter(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+int hal_system_host_resets(void)
+{
+   return resets;
+}
+
+bool hal_system_host_irq_disabled(void)
+{
+   return irqDisabled;
+}
+
+void hal_rtc_host_set(uint32_t value)
+{
+   rtc = value;
+}
+#endif // HOST_BUILD
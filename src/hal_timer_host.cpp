@@ -0,0 +1,115 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_timer.h"
+
+#define NUM_CHANNELS 4
+
+struct Timer
+{
+   uint32_t address;
+   uint16_t prescaler;
+   uint16_t period;
+   bool enabled;
+   uint16_t counter;
+   uint16_t ccr[NUM_CHANNELS];
+   bool irqEnabled[NUM_CHANNELS];
+   bool flag[NUM_CHANNELS];
+};
+
+static Timer timers[] = { { TIM1, 0, 0, false, 0, { 0 }, { false }, { false } },
+                          { TIM2, 0, 0, false, 0, { 0 }, { false }, { false } },
+                          { TIM3, 0, 0, false, 0, { 0 }, { false }, { false } },
+                          { TIM4, 0, 0, false, 0, { 0 }, { false }, { false } } };
+
+static Timer& GetTimer(uint32_t timer)
+{
+   for (unsigned i = 0; i < sizeof(timers) / sizeof(timers[0]); i++)
+   {
+      if (timers[i].address == timer)
+         return timers[i];
+   }
+   assert(!"Unknown timer");
+   return timers[0];
+}
+
+void hal_timer_setup(uint32_t timer, uint16_t prescaler, uint16_t period)
+{
+   GetTimer(timer).prescaler = prescaler;
+   GetTimer(timer).period = period;
+}
+
+void hal_timer_enable(uint32_t timer, bool enable)
+{
+   GetTimer(timer).enabled = enable;
+}
+
+void hal_timer_set_counter(uint32_t timer, uint16_t value)
+{
+   GetTimer(timer).counter = value;
+}
+
+uint16_t hal_timer_get_counter(uint32_t timer)
+{
+   return GetTimer(timer).counter;
+}
+
+void hal_timer_setup_compare(uint32_t timer, int channel, uint16_t value)
+{
+   assert(channel >= 0 && channel < NUM_CHANNELS);
+   GetTimer(timer).ccr[channel] = value;
+   GetTimer(timer).irqEnabled[channel] = true;
+}
+
+bool hal_timer_compare_pending(uint32_t timer, int channel)
+{
+   return GetTimer(timer).flag[channel];
+}
+
+void hal_timer_clear_compare(uint32_t timer, int channel)
+{
+   GetTimer(timer).flag[channel] = false;
+}
+
+void hal_timer_advance_compare(uint32_t timer, int channel, uint16_t ticks)
+{
+   GetTimer(timer).ccr[channel] += ticks;
+}
+
+/** Count the given number of (prescaled) ticks, setting the compare
+ * flag of a channel while the counter holds its compare value */
+void hal_timer_host_tick(uint32_t timer, uint32_t ticks)
+{
+   Timer& t = GetTimer(timer);
+
+   if (!t.enabled) return;
+
+   for (uint32_t i = 0; i < ticks; i++)
+   {
+      for (int c = 0; c < NUM_CHANNELS; c++)
+      {
+         if (t.counter == t.ccr[c])
+            t.flag[c] = true;
+      }
+
+      t.counter = t.counter >= t.period ? 0 : t.counter + 1;
+   }
+}
+#endif // HOST_BUILD
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef HOST_BUILD
+#include <assert.h>
+#include "hal_uart.h"
+
+#define NUM_DMA_CHANNELS 7
+#define OUTPUT_SIZE      4096
+
+/* DMA transfers complete instantly: sending copies the buffer to the
+ * output log, received characters are written straight to memory */
+struct DmaChannel
+{
+   char* buf;
+   int size;
+   int remaining;
+   bool enabled;
+   bool complete;
+   uint32_t usart;
+};
+
+struct Usart
+{
+   uint32_t address;
+   uint32_t baudrate;
+   int stopbits;
+   bool enabled;
+   bool txDma;
+   uint8_t dmarx;
+   bool rxne;
+   uint16_t dr;
+   int outLen;
+   char out[OUTPUT_SIZE];
+};
+
+static DmaChannel channels[NUM_DMA_CHANNELS + 1];
+static Usart usarts[] = { { USART1, 0, 0, false, false, 0, false, 0, 0, { 0 } },
+                          { USART2, 0, 0, false, false, 0, false, 0, 0, { 0 } },
+                          { USART3, 0, 0, false, false, 0, false, 0, 0, { 0 } } };
+
+static Usart& GetUsart(uint32_t usart)
+{
+   for (unsigned i = 0; i < sizeof(usarts) / sizeof(usarts[0]); i++)
+   {
+      if (usarts[i].address == usart)
+         return usarts[i];
+   }
+   assert(!"Unknown USART");
+   return usarts[0];
+}
+
+static DmaChannel& GetChannel(uint8_t channel)
+{
+   assert(channel >= 1 && channel <= NUM_DMA_CHANNELS);
+   return channels[channel];
+}
+
+static void Output(Usart& u, char c)
+{
+   if (u.outLen < OUTPUT_SIZE)
+      u.out[u.outLen++] = c;
+}
+
+void hal_uart_init(uint32_t usart, uint32_t baudrate, uint8_t dmatx, uint8_t dmarx)
+{
+   Usart& u = GetUsart(usart);
+
+   u.baudrate = baudrate;
+   u.stopbits = 2;
+   u.txDma = true;
+   u.dmarx = dmarx;
+   GetChannel(dmatx) = DmaChannel();
+   GetChannel(dmatx).usart = usart;
+   GetChannel(dmarx) = DmaChannel();
+   GetChannel(dmarx).usart = usart;
+   GetChannel(dmarx).enabled = true;
+}
+
+void hal_uart_enable(uint32_t usart)
+{
+   GetUsart(usart).enabled = true;
+}
+
+void hal_uart_set_format(uint32_t usart, uint32_t baudrate, int stopbits)
+{
+   GetUsart(usart).baudrate = baudrate;
+   GetUsart(usart).stopbits = stopbits;
+}
+
+void hal_uart_send_blocking(uint32_t usart, char c)
+{
+   Output(GetUsart(usart), c);
+}
+
+void hal_uart_wait_send_ready(uint32_t usart)
+{
+   (void)usart;
+}
+
+bool hal_uart_rx_ready(uint32_t usart)
+{
+   return GetUsart(usart).rxne;
+}
+
+uint16_t hal_uart_recv(uint32_t usart)
+{
+   GetUsart(usart).rxne = false;
+   return GetUsart(usart).dr;
+}
+
+void hal_uart_disable_tx_dma(uint32_t usart, uint8_t dmatx)
+{
+   GetChannel(dmatx).enabled = false;
+   GetUsart(usart).txDma = false;
+}
+
+void hal_uart_dma_rx_start(uint8_t dmarx, char* buf, int size)
+{
+   DmaChannel& ch = GetChannel(dmarx);
+
+   ch.buf = buf;
+   ch.size = size;
+   ch.remaining = size;
+   ch.enabled = true;
+}
+
+int hal_uart_dma_rx_remaining(uint8_t dmarx)
+{
+   return GetChannel(dmarx).remaining;
+}
+
+bool hal_uart_dma_tx_done(uint8_t dmatx)
+{
+   return GetChannel(dmatx).complete;
+}
+
+void hal_uart_dma_tx_start(uint8_t dmatx, const char* buf, int len)
+{
+   DmaChannel& ch = GetChannel(dmatx);
+   Usart& u = GetUsart(ch.usart);
+
+   for (int i = 0; i < len; i++)
+      Output(u, buf[i]);
+
+   ch.complete = true;
+}
+
+/** Receive characters, via DMA if enabled, else into the data register
+ * @return number of characters accepted */
+int hal_uart_host_receive(uint32_t usart, const char* data, int len)
+{
+   Usart& u = GetUsart(usart);
+   DmaChannel& ch = GetChannel(u.dmarx);
+   int i = 0;
+
+   for (; i < len; i++)
+   {
+      if (ch.enabled && ch.buf != 0)
+      {
+         if (ch.remaining == 0) break; //Buffer full, DMA stops
+         ch.buf[ch.size - ch.remaining] = data[i];
+         ch.remaining--;
+      }
+      else
+      {
+         u.dr = data[i];
+         u.rxne = true;
+      }
+   }
+   return i;
+}
+
+/** Move sent characters to buf and clear the log
+ * @return number of characters copied */
+int hal_uart_host_transmitted(uint32_t usart, char* buf, int size)
+{
+   Usart& u = GetUsart(usart);
+   int len = u.outLen < size ? u.outLen : size;
+
+   for (int i = 0; i < len; i++)
+      buf[i] = u.out[i];
+
+   for (int i = len; i < u.outLen; i++)
+      u.out[i - len] = u.out[i];
+
+   u.outLen -= len;
+   return len;
+}
+#endif // HOST_BUILD
@@ -51,8 +51,9 @@ char* fp_itoa(char * buf, s32fp a)
 
 s32fp fp_atoi(const char *str, int fracDigits)
 {
-   int nat = 0;
-   int frac = 0;
+   //Unsigned so out of range input wraps instead of overflowing
+   uint32_t nat = 0;
+   uint32_t frac = 0;
    int div = 10;
    int sign = 1;
    if ('-' == *str)
@@ -69,12 +70,15 @@ s32fp fp_atoi(const char *str, int fracDigits)
    {
       for (str++; *str >= '0' && *str <= '9'; str++)
       {
+         //Further digits are below resolution and div would overflow
+         if (div > 100000000) continue;
          frac += (div / 2 + ((*str - '0') << fracDigits)) / div;
          div *= 10;
       }
    }
 
-   return sign * ((nat << fracDigits) + frac);
+   nat = (nat << fracDigits) + frac;
+   return (s32fp)(sign < 0 ? 0u - nat : nat);
 }
 
 u32fp fp_sqrt(u32fp rad)
@@ -99,7 +99,8 @@ int my_ltoa(char *buf, int val, int base)
 
 int my_atoi(const char *str)
 {
-   int Res = 0;
+   //Unsigned so out of range input wraps instead of overflowing
+   unsigned int Res = 0;
    int sign = 1;
    if ('-' == *str)
    {
@@ -112,7 +113,36 @@ int my_atoi(const char *str)
       Res += *str - '0';
    }
 
-   return sign * Res;
+   return (int)(sign < 0 ? 0u - Res : Res);
+}
+
+/** Convert a decimal or 0x prefixed hexadecimal string, covers the full unsigned range */
+unsigned int my_atoui(const char *str)
+{
+   unsigned int Res = 0;
+
+   if ('0' == str[0] && ('x' == str[1] || 'X' == str[1]))
+   {
+      for (str += 2; ; str++)
+      {
+         if (*str >= '0' && *str <= '9')
+            Res = (Res << 4) + *str - '0';
+         else if ((*str | 0x20) >= 'a' && (*str | 0x20) <= 'f')
+            Res = (Res << 4) + (*str | 0x20) - 'a' + 10;
+         else
+            break;
+      }
+   }
+   else
+   {
+      for (; *str >= '0' && *str <= '9'; str++)
+      {
+         Res *= 10;
+         Res += *str - '0';
+      }
+   }
+
+   return Res;
 }
 
 char *my_trim(char *str)
@@ -17,8 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <libopencm3/stm32/flash.h>
-#include <libopencm3/stm32/crc.h>
+#include "hal_flash.h"
 #include "params.h"
 #include "param_save.h"
 #include "hwdefs.h"
@@ -52,28 +51,27 @@ uint32_t parm_save()
    PARAM_PAGE parmPage;
    unsigned int idx;
 
-   crc_reset();
+   hal_crc_reset();
    memset32((int*)&parmPage, 0xFFFFFFFF, PARAM_WORDS);
 
    //Copy parameter values and keys to block structure
    for (idx = 0; Param::IsParam((Param::PARAM_NUM)idx) && idx < NUM_PARAMS; idx++)
    {
-      const Param::Attributes *pAtr = Param::GetAttrib((Param::PARAM_NUM)idx);
       parmPage.data[idx].flags = (uint8_t)Param::GetFlag((Param::PARAM_NUM)idx);
-      parmPage.data[idx].key = pAtr->id;
-      parmPage.data[idx].value = Param::Get((Param::PARAM_NUM)idx);
+      parmPage.data[idx].key = Param::GetId((Param::PARAM_NUM)idx);
+      parmPage.data[idx].value = Param::GetRaw((Param::PARAM_NUM)idx);
    }
 
-   parmPage.crc = crc_calculate_block(((uint32_t*)&parmPage), (2 * NUM_PARAMS));
-   flash_unlock();
-   flash_erase_page(PARAM_ADDRESS);
+   parmPage.crc = hal_crc_calculate_block(((uint32_t*)&parmPage), (2 * NUM_PARAMS));
+   hal_flash_unlock();
+   hal_flash_erase_page(PARAM_ADDRESS);
 
    for (idx = 0; idx < PARAM_WORDS; idx++)
    {
       uint32_t* pData = ((uint32_t*)&parmPage) + idx;
-      flash_program_word(PARAM_ADDRESS + idx * sizeof(uint32_t), *pData);
+      hal_flash_program_word(PARAM_ADDRESS + idx * sizeof(uint32_t), *pData);
    }
-   flash_lock();
+   hal_flash_lock();
    return parmPage.crc;
 }
 
@@ -85,10 +83,10 @@ uint32_t parm_save()
 */
 int parm_load()
 {
-   PARAM_PAGE *parmPage = (PARAM_PAGE *)PARAM_ADDRESS;
+   const PARAM_PAGE *parmPage = (const PARAM_PAGE *)hal_flash_pointer(PARAM_ADDRESS);
 
-   crc_reset();
-   uint32_t crc = crc_calculate_block(((uint32_t*)parmPage), (2 * NUM_PARAMS));
+   hal_crc_reset();
+   uint32_t crc = hal_crc_calculate_block(((const uint32_t*)parmPage), (2 * NUM_PARAMS));
 
    if (crc == parmPage->crc)
    {
@@ -97,7 +95,7 @@ int parm_load()
          Param::PARAM_NUM idx = Param::NumFromId(parmPage->data[idxPage].key);
          if (idx != Param::PARAM_INVALID && parmPage->data[idxPage].key > 0)
          {
-            Param::SetFlt(idx, parmPage->data[idxPage].value);
+            Param::SetRaw(idx, parmPage->data[idxPage].value);
             Param::SetFlagsRaw(idx, parmPage->data[idxPage].flags);
          }
       }
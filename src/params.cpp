@@ -19,77 +19,389 @@
 
 #include "params.h"
 #include "my_string.h"
+#include "my_math.h"
+#include "hal_system.h"
 
 namespace Param
 {
 
-#define PARAM_ENTRY(category, name, unit, min, max, def, id) { category, #name, unit, FP_FROMFLT(min), FP_FROMFLT(max), FP_FROMFLT(def), id },
-#define VALUE_ENTRY(name, unit, id) { 0, #name, unit, 0, 0, 0, id },
-static const Attributes attribs[] =
+#define CONVERT_FIXED(a)    FP_FROMFLT(a)
+#define CONVERT_INT(a)      ((s32fp)(a))
+#define CONVERT_ENUM(a)     ((s32fp)(a))
+#define CONVERT_BITFIELD(a) ((s32fp)(a))
+
+/* Attributes are split by access pattern: Set(), IsParam() and NumFromId()
+ * only touch the dense limits and ids arrays, the strings are only needed
+ * by the terminal and can be dropped by the linker when it is not used.
+ * NumFromId() and NumFromString() binary search index tables that are
+ * sorted by the compiler, see below */
+struct Limits
+{
+   s32fp min;
+   s32fp max;
+};
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) { FP_FROMFLT(min), FP_FROMFLT(max) },
+#define VALUE_ENTRY(name, unit, id) { 0, 0 },
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) { CONVERT_##type(min), CONVERT_##type(max) },
+#define TYPED_VALUE_ENTRY(name, unit, id, type) { 0, 0 },
+static const Limits limits[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) id,
+#define VALUE_ENTRY(name, unit, id) id,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) id,
+#define TYPED_VALUE_ENTRY(name, unit, id, type) id,
+static constexpr uint16_t ids[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) KindOf(name),
+#define VALUE_ENTRY(name, unit, id) KindOf(name),
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) KindOf(name),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) KindOf(name),
+static const uint8_t kinds[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) FP_FROMFLT(def),
+#define VALUE_ENTRY(name, unit, id) 0,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) CONVERT_##type(def),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) 0,
+static const s32fp defaults[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) { category, #name, unit },
+#define VALUE_ENTRY(name, unit, id) { 0, #name, unit },
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) { category, #name, unit },
+#define TYPED_VALUE_ENTRY(name, unit, id, type) { 0, #name, unit },
+static constexpr Attributes attribs[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+/* Everything from here to values[] is evaluated by the compiler. The functions
+ * are C++11 constexpr, i.e. a single return statement, loops become recursion.
+ * Ranking is O(N²) in the number of entries: with 240 entries this file takes
+ * about 4 s instead of 0.1 s to compile on a slow host. The recursion depth
+ * stays at log2(N) + 16 for Sum() plus the name length for NameCompare(),
+ * far below the default constexpr depth limit of 512 */
+
+/** Sum of Term::Value(j, i) over all j in [lo, hi). Short ranges are walked
+ * linearly, longer ones split in halves to bound the recursion depth */
+template<typename Term>
+constexpr int Sum(int i, int lo, int hi)
+{
+   return hi - lo > 16 ? Sum<Term>(i, lo, (lo + hi) / 2) + Sum<Term>(i, (lo + hi) / 2, hi) :
+          lo < hi ? Term::Value(lo, i) + Sum<Term>(i, lo + 1, hi) : 0;
+}
+
+/** Compare two names, used at compile time for sorting and at run time for the binary search */
+constexpr int NameCompare(const char* a, const char* b)
+{
+   return *a != 0 && *a == *b ? NameCompare(a + 1, b + 1) : *a - *b;
+}
+
+/** 1 if entry j sorts before entry i by id, ties are sorted by index */
+struct IdBefore
+{
+   static constexpr int Value(int j, int i) { return ids[j] < ids[i] || (ids[j] == ids[i] && j < i); }
+};
+
+/** First eight characters of a name packed into an integer, orders like NameCompare() up to ties */
+constexpr uint64_t NamePrefix(const char* name, int n)
+{
+   return n == 0 ? 0 : ((uint64_t)(uint8_t)*name << (8 * (n - 1))) | (*name != 0 ? NamePrefix(name + 1, n - 1) : 0);
+}
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) NamePrefix(#name, 8),
+#define VALUE_ENTRY(name, unit, id) NamePrefix(#name, 8),
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) NamePrefix(#name, 8),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) NamePrefix(#name, 8),
+static constexpr uint64_t namePrefixes[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+/** 1 if entry j sorts before entry i by name. Comparing the prefixes first
+ * avoids walking both strings for most of the N² pairs */
+struct NameBefore
+{
+   static constexpr int Value(int j, int i)
+   {
+      return namePrefixes[j] != namePrefixes[i] ? namePrefixes[j] < namePrefixes[i] :
+             NameCompare(attribs[j].name, attribs[i].name) < 0;
+   }
+};
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) Sum<IdBefore>(name, 0, PARAM_LAST),
+#define VALUE_ENTRY(name, unit, id) Sum<IdBefore>(name, 0, PARAM_LAST),
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) Sum<IdBefore>(name, 0, PARAM_LAST),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) Sum<IdBefore>(name, 0, PARAM_LAST),
+static constexpr uint16_t idRanks[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) Sum<NameBefore>(name, 0, PARAM_LAST),
+#define VALUE_ENTRY(name, unit, id) Sum<NameBefore>(name, 0, PARAM_LAST),
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) Sum<NameBefore>(name, 0, PARAM_LAST),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) Sum<NameBefore>(name, 0, PARAM_LAST),
+static constexpr uint16_t nameRanks[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+/** j + 1 if entry j has rank r, 0 otherwise. Summed up this finds the one entry with rank r */
+struct IdRankIs
+{
+   static constexpr int Value(int j, int r) { return idRanks[j] == r ? j + 1 : 0; }
+};
+
+struct NameRankIs
+{
+   static constexpr int Value(int j, int r) { return nameRanks[j] == r ? j + 1 : 0; }
+};
+
+/* Parameter indices sorted by id and by name for binary search. Element n
+ * is the index whose rank is n, the enum value of each name serves as n */
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) Sum<IdRankIs>(name, 0, PARAM_LAST) - 1,
+#define VALUE_ENTRY(name, unit, id) Sum<IdRankIs>(name, 0, PARAM_LAST) - 1,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) Sum<IdRankIs>(name, 0, PARAM_LAST) - 1,
+#define TYPED_VALUE_ENTRY(name, unit, id, type) Sum<IdRankIs>(name, 0, PARAM_LAST) - 1,
+static constexpr uint16_t sortedById[] =
+{
+    PARAM_LIST
+};
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) Sum<NameRankIs>(name, 0, PARAM_LAST) - 1,
+#define VALUE_ENTRY(name, unit, id) Sum<NameRankIs>(name, 0, PARAM_LAST) - 1,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) Sum<NameRankIs>(name, 0, PARAM_LAST) - 1,
+#define TYPED_VALUE_ENTRY(name, unit, id, type) Sum<NameRankIs>(name, 0, PARAM_LAST) - 1,
+static constexpr uint16_t sortedByName[] =
 {
     PARAM_LIST
 };
 #undef PARAM_ENTRY
 #undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+/** True if the entry following entry i in id order has the same id */
+constexpr bool NextIdEqual(int i)
+{
+   return idRanks[i] + 1 < PARAM_LAST && ids[sortedById[idRanks[i] + 1]] == ids[i];
+}
+
+/** 1 if entry j has id 0, those keep their value in LoadDefaults() */
+struct IdIsZero
+{
+   static constexpr int Value(int j, int) { return ids[j] == 0; }
+};
+
+#define INRANGE_FIXED(min, max, def)    ((def) >= (min) && (def) <= (max))
+#define INRANGE_INT(min, max, def)      INRANGE_FIXED(min, max, def)
+#define INRANGE_ENUM(min, max, def)     INRANGE_FIXED(min, max, def)
+#define INRANGE_BITFIELD(min, max, def) true
+
+/* Duplicates are adjacent in id order, so checking the next entry catches each of them once */
+#define CHECK_ID(name, id) \
+   static_assert((id) >= 0 && (id) <= 0xFFFF, "ID of " #name " exceeds 16 bits"); \
+   static_assert((id) == 0 || !NextIdEqual(name), "ID of " #name " is not unique");
+#define PARAM_ENTRY(category, name, unit, min, max, def, id) CHECK_ID(name, id) \
+   static_assert(INRANGE_FIXED(min, max, def), "Default of " #name " outside min/max");
+#define VALUE_ENTRY(name, unit, id) CHECK_ID(name, id)
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) CHECK_ID(name, id) \
+   static_assert(INRANGE_##type(min, max, def), "Default of " #name " outside min/max");
+#define TYPED_VALUE_ENTRY(name, unit, id, type) CHECK_ID(name, id)
+PARAM_LIST
+#undef PARAM_ENTRY
+#undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+#undef CHECK_ID
 
 #define PARAM_ENTRY(category, name, unit, min, max, def, id) FP_FROMFLT(def),
 #define VALUE_ENTRY(name, unit, id) 0,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) CONVERT_##type(def),
+#define TYPED_VALUE_ENTRY(name, unit, id, type) 0,
 static s32fp values[] =
 {
     PARAM_LIST
 };
 #undef PARAM_ENTRY
 #undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
 
 #define PARAM_ENTRY(category, name, unit, min, max, def, id) 0,
 #define VALUE_ENTRY(name, unit, id) 0,
+#define TYPED_ENTRY(category, name, unit, min, max, def, id, type) 0,
+#define TYPED_VALUE_ENTRY(name, unit, id, type) 0,
 static uint8_t flags[] =
 {
     PARAM_LIST
 };
 #undef PARAM_ENTRY
 #undef VALUE_ENTRY
+#undef TYPED_ENTRY
+#undef TYPED_VALUE_ENTRY
+
+#if PARAM_HISTORY_SIZE > 0
+static HistoryEntry history[PARAM_HISTORY_SIZE];
+static uint32_t historyCount = 0; //Total number of recorded changes
+static uint32_t historyTime = 0;
+
+/** Append a change to the history ring, overwrites the oldest entry when full.
+ * Only called for actual changes, so unchanged writes never mask interrupts */
+static void Record(PARAM_NUM ParamNum, int32_t oldVal, int32_t newVal, PARAM_SOURCE source)
+{
+   if (limits[ParamNum].min == limits[ParamNum].max) return;
+
+   //Changes come from the main loop and interrupts (CAN), keep entry and count consistent
+   uint32_t irqMask = hal_irq_mask(1);
+   HistoryEntry& entry = history[historyCount % PARAM_HISTORY_SIZE];
+
+   entry.time = historyTime;
+   entry.oldVal = oldVal;
+   entry.newVal = newVal;
+   entry.param = ParamNum;
+   entry.source = source;
+   historyCount++;
+   hal_irq_mask(irqMask);
+}
+#else
+static inline void Record(PARAM_NUM, int32_t, int32_t, PARAM_SOURCE) {}
+#endif
 
 /**
-* Set a parameter
+* Range check and store a value in storage format, fixed point or integer
+* depending on kind, see GetRaw()
 *
 * @param[in] ParamNum Parameter index
-* @param[in] ParamVal New value of parameter
+* @param[in] ParamVal New value of parameter in storage format
+* @param[in] source Originator of the change, for the change history
 * @return 0 if set ok, -1 if ParamVal outside of allowed range
 */
-int Set(PARAM_NUM ParamNum, s32fp ParamVal)
+int SetRawChecked(PARAM_NUM ParamNum, int32_t ParamVal, PARAM_SOURCE source)
 {
     char res = -1;
 
-    if (ParamVal >= attribs[ParamNum].min && ParamVal <= attribs[ParamNum].max)
+    if ((ParamVal >= limits[ParamNum].min && ParamVal <= limits[ParamNum].max) ||
+        (kinds[ParamNum] == KIND_BITFIELD && limits[ParamNum].min != limits[ParamNum].max))
     {
-        values[ParamNum] = ParamVal;
+        if (values[ParamNum] != ParamVal)
+        {
+           Record(ParamNum, values[ParamNum], ParamVal, source);
+           values[ParamNum] = ParamVal;
+        }
         parm_Change(ParamNum);
         res = 0;
     }
     return res;
 }
 
+/**
+* Set a parameter
+*
+* @param[in] ParamNum Parameter index
+* @param[in] ParamVal New value of parameter, fixed point for all kinds
+* @param[in] source Originator of the change, for the change history
+* @return 0 if set ok, -1 if ParamVal outside of allowed range
+*/
+int Set(PARAM_NUM ParamNum, s32fp ParamVal, PARAM_SOURCE source)
+{
+    if (kinds[ParamNum] != KIND_FIXED)
+       ParamVal >>= FRAC_DIGITS;
+
+    return SetRawChecked(ParamNum, ParamVal, source);
+}
+
+/**
+* Set a parameters digit value with range check, covers the full 32 bit range of integer kinds
+*
+* @param[in] ParamNum Parameter index
+* @param[in] ParamVal New value of parameter
+* @param[in] source Originator of the change, for the change history
+* @return 0 if set ok, -1 if ParamVal outside of allowed range
+*/
+int SetIntChecked(PARAM_NUM ParamNum, int ParamVal, PARAM_SOURCE source)
+{
+    if (kinds[ParamNum] == KIND_FIXED)
+       ParamVal = FP_FROMINT(ParamVal);
+
+    return SetRawChecked(ParamNum, ParamVal, source);
+}
+
 /**
 * Get a parameters fixed point value
 *
 * @param[in] ParamNum Parameter index
-* @return Parameters value
+* @return Parameters value, integer kinds are converted and saturated to the
+*         fixed point range. Use GetInt() or GetRaw() for their full range
 */
 s32fp Get(PARAM_NUM ParamNum)
 {
-    return values[ParamNum];
+    s32fp val = values[ParamNum];
+
+    if (kinds[ParamNum] == KIND_FIXED)
+       return val;
+
+    val = MAX(MIN(val, FP_TOINT(INT32_MAX)), FP_TOINT(INT32_MIN));
+    return FP_FROMINT(val);
 }
 
 /**
 * Get a parameters unscaled digit value
 *
 * @param[in] ParamNum Parameter index
-* @return Parameters value
+* @return Parameters value, full 32 bit for integer kinds
 */
 int GetInt(PARAM_NUM ParamNum)
 {
-    return FP_TOINT(values[ParamNum]);
+    return kinds[ParamNum] == KIND_FIXED ? FP_TOINT(values[ParamNum]) : values[ParamNum];
 }
 
 /**
@@ -100,29 +412,47 @@ int GetInt(PARAM_NUM ParamNum)
 */
 bool GetBool(PARAM_NUM ParamNum)
 {
-    return FP_TOINT(values[ParamNum]) == 1;
+    return GetInt(ParamNum) == 1;
+}
+
+/** Get the kind of a parameter, it defines the storage format */
+PARAM_KIND GetKind(PARAM_NUM ParamNum)
+{
+    return (PARAM_KIND)kinds[ParamNum];
+}
+
+/** Get value in storage format (fixed point or integer depending on kind), for persistence */
+int32_t GetRaw(PARAM_NUM ParamNum)
+{
+    return values[ParamNum];
+}
+
+/** Set value in storage format without range check, for persistence */
+void SetRaw(PARAM_NUM ParamNum, int32_t ParamVal)
+{
+    values[ParamNum] = ParamVal;
 }
 
 /**
-* Set a parameters digit value
+* Set a parameters digit value, unchecked and not recorded in the change history
 *
 * @param[in] ParamNum Parameter index
 * @param[in] ParamVal New value of parameter
 */
 void SetInt(PARAM_NUM ParamNum, int ParamVal)
 {
-   values[ParamNum] = FP_FROMINT(ParamVal);
+   values[ParamNum] = kinds[ParamNum] == KIND_FIXED ? FP_FROMINT(ParamVal) : ParamVal;
 }
 
 /**
-* Set a parameters fixed point value
+* Set a parameters fixed point value, unchecked and not recorded in the change history
 *
 * @param[in] ParamNum Parameter index
 * @param[in] ParamVal New value of parameter
 */
 void SetFlt(PARAM_NUM ParamNum, s32fp ParamVal)
 {
-   values[ParamNum] = ParamVal;
+   values[ParamNum] = kinds[ParamNum] == KIND_FIXED ? ParamVal : ParamVal >> FRAC_DIGITS;
 }
 
 /**
@@ -133,18 +463,21 @@ void SetFlt(PARAM_NUM ParamNum, s32fp ParamVal)
 */
 PARAM_NUM NumFromString(const char *name)
 {
-    PARAM_NUM paramNum = PARAM_INVALID;
-    const Attributes *pCurAtr = attribs;
+    int lo = 0, hi = PARAM_LAST;
 
-    for (int i = 0; i < PARAM_LAST; i++, pCurAtr++)
+    while (lo < hi)
     {
-         if (0 == my_strcmp(pCurAtr->name, name))
-         {
-             paramNum = (PARAM_NUM)i;
-             break;
-         }
+       int mid = (lo + hi) / 2;
+       int cmp = NameCompare(attribs[sortedByName[mid]].name, name);
+
+       if (cmp == 0)
+          return (PARAM_NUM)sortedByName[mid];
+       else if (cmp < 0)
+          lo = mid + 1;
+       else
+          hi = mid;
     }
-    return paramNum;
+    return PARAM_INVALID;
 }
 
 /**
@@ -155,49 +488,83 @@ PARAM_NUM NumFromString(const char *name)
 */
 PARAM_NUM NumFromId(uint32_t id)
 {
-    PARAM_NUM paramNum = PARAM_INVALID;
-    const Attributes *pCurAtr = attribs;
+    int lo = 0, hi = PARAM_LAST;
 
-    for (int i = 0; i < PARAM_LAST; i++, pCurAtr++)
+    while (lo < hi)
     {
-         if (pCurAtr->id == id)
-         {
-             paramNum = (PARAM_NUM)i;
-             break;
-         }
+       int mid = (lo + hi) / 2;
+
+       if (ids[sortedById[mid]] < id)
+          lo = mid + 1;
+       else
+          hi = mid;
     }
-    return paramNum;
+
+    if (lo < PARAM_LAST && ids[sortedById[lo]] == id)
+       return (PARAM_NUM)sortedById[lo];
+    return PARAM_INVALID;
 }
 
 /**
 * Get the parameter attributes
 *
 * @param[in] ParamNum Parameter index
-* @return Parameter attributes
+* @return Parameter name, unit and category
 */
 const Attributes *GetAttrib(PARAM_NUM ParamNum)
 {
     return &attribs[ParamNum];
 }
 
+/** Get minimum value of a parameter in storage format, see GetRaw() */
+s32fp GetMin(PARAM_NUM ParamNum)
+{
+   return limits[ParamNum].min;
+}
+
+/** Get maximum value of a parameter in storage format */
+s32fp GetMax(PARAM_NUM ParamNum)
+{
+   return limits[ParamNum].max;
+}
+
+/** Get default value of a parameter in storage format */
+s32fp GetDefault(PARAM_NUM ParamNum)
+{
+   return defaults[ParamNum];
+}
+
+/** Get unique id of a parameter, used for persistence and CAN mapping */
+uint32_t GetId(PARAM_NUM ParamNum)
+{
+   return ids[ParamNum];
+}
+
 /** Find out if ParamNum is a parameter or display value
  * @retval 1 it is a parameter
  * @retval 0 otherwise
  */
 int IsParam(PARAM_NUM ParamNum)
 {
-   return attribs[ParamNum].min != attribs[ParamNum].max;
+   return limits[ParamNum].min != limits[ParamNum].max;
 }
 
 /** Load default values for all parameters */
 void LoadDefaults()
 {
-   const Attributes *curAtr = attribs;
+   //defaults[] is already in storage format, so without id 0 entries this is a plain copy.
+   //Like the loop below it bypasses the change history on purpose, reloading all
+   //defaults would otherwise flush the history with one entry per parameter
+   if (Sum<IdIsZero>(0, 0, PARAM_LAST) == 0)
+   {
+      memcpy32((int*)values, (int*)defaults, PARAM_LAST);
+      return;
+   }
 
-   for (int idx = 0; idx < PARAM_LAST; idx++, curAtr++)
+   for (int idx = 0; idx < PARAM_LAST; idx++)
    {
-      if (curAtr->id > 0)
-         SetFlt((PARAM_NUM)idx, curAtr->def);
+      if (ids[idx] > 0)
+         values[idx] = defaults[idx];
    }
 }
 
@@ -221,4 +588,50 @@ PARAM_FLAG GetFlag(PARAM_NUM param)
    return (PARAM_FLAG)flags[param];
 }
 
+/** Set the timestamp of subsequent history entries, e.g. from a 100ms or 1s tick */
+void SetHistoryTime(uint32_t time)
+{
+#if PARAM_HISTORY_SIZE > 0
+   historyTime = time;
+#else
+   (void)time;
+#endif
+}
+
+/** Get a change history entry
+ *
+ * @param[in] n Age of the entry, 0 is the most recent change
+ * @param[out] entry Copy of the recorded change
+ * @return true if the entry exists, false when n exceeds the recorded changes
+ */
+bool GetHistory(uint32_t n, HistoryEntry& entry)
+{
+#if PARAM_HISTORY_SIZE > 0
+   bool valid;
+   uint32_t irqMask = hal_irq_mask(1);
+
+   valid = n < historyCount && n < PARAM_HISTORY_SIZE;
+
+   if (valid)
+      entry = history[(historyCount - 1 - n) % PARAM_HISTORY_SIZE];
+
+   hal_irq_mask(irqMask);
+   return valid;
+#else
+   (void)n;
+   (void)entry;
+   return false;
+#endif
+}
+
+/** Forget all recorded changes */
+void ClearHistory()
+{
+#if PARAM_HISTORY_SIZE > 0
+   uint32_t irqMask = hal_irq_mask(1);
+   historyCount = 0;
+   hal_irq_mask(irqMask);
+#endif
+}
+
 }
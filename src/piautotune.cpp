@@ -0,0 +1,117 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "piautotune.h"
+#include "my_math.h"
+
+/* Give up when one oscillation period takes longer than this */
+#define TIMEOUT_SECONDS   5
+/* 0.45 * 4 / pi and 0.54 * 4 / pi scaled by 1000 */
+#define ZN_KP_FAC         573
+#define ZN_KI_FAC         688
+
+PiAutotune::PiAutotune(Param::PARAM_NUM kpParam, Param::PARAM_NUM kiParam)
+ : kpParam(kpParam), kiParam(kiParam), state(IDLE), kp(0), ki(0), kiFrequency(1)
+{
+}
+
+void PiAutotune::Start(s32fp ref, int32_t bias, int32_t amplitude, s32fp hysteresis, int frequency, int cycles)
+{
+   refVal = ref;
+   this->bias = bias;
+   this->amplitude = amplitude;
+   this->hysteresis = hysteresis;
+   this->frequency = frequency;
+   this->cycles = cycles;
+   relayHigh = true;
+   calls = 0;
+   lastRisingEdge = 0;
+   periodCount = -1; //first period is discarded as it contains the transient
+   periodSum = 0;
+   ampSum = 0;
+   maxVal = ref;
+   minVal = ref;
+   state = RUNNING;
+}
+
+int32_t PiAutotune::Run(s32fp curVal)
+{
+   if (state != RUNNING) return bias;
+
+   s32fp err = refVal - curVal;
+   calls++;
+   maxVal = MAX(maxVal, curVal);
+   minVal = MIN(minVal, curVal);
+
+   if (relayHigh && err < -hysteresis)
+   {
+      relayHigh = false;
+   }
+   else if (!relayHigh && err > hysteresis)
+   {
+      relayHigh = true;
+
+      if (periodCount >= 0)
+      {
+         periodSum += calls - lastRisingEdge;
+         ampSum += (maxVal - minVal) / 2;
+      }
+      periodCount++;
+      lastRisingEdge = calls;
+      maxVal = curVal;
+      minVal = curVal;
+
+      if (periodCount == cycles)
+      {
+         Calculate();
+      }
+   }
+
+   if ((calls - lastRisingEdge) > (uint32_t)(frequency * TIMEOUT_SECONDS))
+   {
+      state = FAILED;
+   }
+
+   return relayHigh ? bias + amplitude : bias - amplitude;
+}
+
+void PiAutotune::Calculate()
+{
+   s32fp ampAvg = ampSum / cycles;
+   uint32_t periodAvg = periodSum / cycles;
+
+   if (ampAvg <= 0 || periodAvg == 0)
+   {
+      state = FAILED;
+      return;
+   }
+
+   //amplitude is in actuator digits, ampAvg is fixed point
+   kp = ((int64_t)ZN_KP_FAC * amplitude * FRAC_FAC) / (1000 * (int64_t)ampAvg);
+   ki = ((int64_t)ZN_KI_FAC * amplitude * FRAC_FAC * frequency) / (1000 * (int64_t)ampAvg * periodAvg);
+   //PiController integrates in steps of ki / FRAC_FAC digits, as coarse as
+   //its proportional steps at most. Lower the calling frequency it is told
+   //instead, the same integral action then takes a smaller ki
+   kiFrequency = MAX(1, MIN(frequency, ((int64_t)frequency * kp) / MAX(ki, 1)));
+   ki = ((int64_t)ki * kiFrequency) / frequency;
+
+   if (Param::Set(kpParam, FP_FROMINT(kp)) == 0 && Param::Set(kiParam, FP_FROMINT(ki)) == 0)
+      state = DONE;
+   else
+      state = FAILED;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "picontroller64.h"
+#include "my_math.h"
+
+#define ESUM_MAX 0x7FFFFFFF
+
+PiController64::PiController64()
+ : kp(0), ki(0), esum(0), refVal(0), frequency(1), maxY(0), minY(0)
+{
+   CalcFactors();
+}
+
+/** Same calculation as PiController::Run() with the divisions replaced by
+ * reciprocal multiplications. Anti windup corrections of 2^31 and above only
+ * occur far in saturation, where PiController overflows. They fall back to a
+ * real division.
+ */
+int32_t PiController64::Run(s32fp curVal)
+{
+   s32fp err = refVal - curVal;
+
+   int64_t sum = (int64_t)esum + err;
+   esum = MAX(MIN(sum, ESUM_MAX), -ESUM_MAX);
+
+   int64_t y = ((int64_t)err * kp + (int64_t)Divide(esum, invFrequency) * ki) >> CST_DIGITS;
+   int64_t ylim = MAX(y, minY);
+   ylim = MIN(ylim, maxY);
+
+   if (ylim != y) //anti windup
+   {
+      int64_t excess = (ylim - y) * frequency;
+
+      if (excess >= -ESUM_MAX && excess <= ESUM_MAX)
+         sum = (int64_t)esum + Divide((int32_t)excess, invKiPlus1);
+      else
+         sum = (int64_t)esum + excess / (ki + 1);
+
+      esum = MAX(MIN(sum, ESUM_MAX), -ESUM_MAX);
+   }
+
+   return ylim;
+}
+
+void PiController64::PreloadIntegrator(int32_t yieldedOutput)
+{
+   int64_t sum = ((int64_t)yieldedOutput * frequency) / (ki + 1);
+   esum = MAX(MIN(sum, ESUM_MAX), -ESUM_MAX);
+}
+
+/** Precompute the reciprocals of frequency and ki + 1 */
+void PiController64::CalcFactors()
+{
+   invFrequency = CalcReciprocal(frequency);
+   invKiPlus1 = CalcReciprocal(ki + 1);
+}
+
+/** Find m and s so that n / d = n * m >> s for 0 <= n < 2^31.
+ * With l = ceil(log2(d)), s = 31 + l and m = ceil(2^s / d) the error of m
+ * is below 2^l / 2^s, which never changes the integer part of the quotient
+ * (Granlund, Montgomery: Division by invariant integers using
+ * multiplication). m stays below 2^32, so n * m fits in 64 bit.
+ * @pre divisor != 0
+ */
+PiController64::Reciprocal PiController64::CalcReciprocal(int32_t divisor)
+{
+   Reciprocal r;
+   uint32_t d = divisor < 0 ? -(uint32_t)divisor : divisor;
+   int l = 0;
+
+   while (l < 32 && ((uint64_t)1 << l) < d) l++;
+
+   r.shift = 31 + l;
+   r.mul = (((uint64_t)1 << r.shift) + d - 1) / d;
+   r.negative = divisor < 0;
+   return r;
+}
+
+/** Truncating division, like the / operator
+ * @pre |dividend| < 2^31 */
+int32_t PiController64::Divide(int32_t dividend, const Reciprocal& r)
+{
+   uint32_t n = dividend < 0 ? -(uint32_t)dividend : dividend;
+   int32_t q = ((uint64_t)n * r.mul) >> r.shift;
+
+   return (dividend < 0) != r.negative ? -q : q;
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include "pmsmmodel.h"
+
+/* Not FRAC_FAC, that follows CST_DIGITS of the including file */
+#define FP_SCALE ((float)(1 << FRAC_DIGITS))
+
+const float PmsmModel::TWO_PI = 6.283185307f;
+
+PmsmModel::PmsmModel()
+ : rs(0.1f), ld(1e-4f), lq(1e-4f), fluxLinkage(0.05f), polePairs(1),
+   inertia(0), friction(0), loadTorque(0), dt(1e-4f), subSteps(1), pwmRange(65536),
+   id(0), iq(0), il1(0), il2(0), angle(0), omega(0), torque(0), idc(0)
+{
+}
+
+void PmsmModel::SetElectricalParameters(float rs, float ld, float lq, float fluxLinkage, int polePairs)
+{
+   this->rs = rs;
+   this->ld = ld;
+   this->lq = lq;
+   this->fluxLinkage = fluxLinkage;
+   this->polePairs = polePairs;
+}
+
+void PmsmModel::SetMechanicalParameters(float inertia, float friction)
+{
+   this->inertia = inertia;
+   this->friction = friction;
+}
+
+void PmsmModel::SetCallingFrequency(int frequency, int subSteps)
+{
+   this->subSteps = subSteps > 0 ? subSteps : 1;
+   dt = 1.0f / (frequency * this->subSteps);
+}
+
+void PmsmModel::SetSpeed(float rpm)
+{
+   omega = rpm * polePairs * TWO_PI / 60.0f;
+}
+
+float PmsmModel::GetSpeed()
+{
+   return omega * 60.0f / (TWO_PI * polePairs);
+}
+
+s32fp PmsmModel::GetIl1()
+{
+   return (s32fp)(il1 * FP_SCALE);
+}
+
+s32fp PmsmModel::GetIl2()
+{
+   return (s32fp)(il2 * FP_SCALE);
+}
+
+void PmsmModel::Step(const int32_t* dutyCycles, s32fp udc)
+{
+   float u = udc / (FP_SCALE * pwmRange);
+   float d1 = dutyCycles[0], d2 = dutyCycles[1], d3 = dutyCycles[2];
+   float common = (d1 + d2 + d3) / 3;
+   //Averaged phase voltages against star point
+   float u1 = (d1 - common) * u;
+   float u2 = (d2 - common) * u;
+   float u3 = (d3 - common) * u;
+   float ualpha = u1;
+   float ubeta = (u2 - u3) * 0.577350269f;
+
+   for (int i = 0; i < subSteps; i++)
+   {
+      float sin = sinf(angle);
+      float cos = cosf(angle);
+      float ud = cos * ualpha + sin * ubeta;
+      float uq = cos * ubeta - sin * ualpha;
+
+      //Semi implicit Euler, the cross coupling uses the updated id
+      id += dt * (ud - rs * id + omega * lq * iq) / ld;
+      iq += dt * (uq - rs * iq - omega * (ld * id + fluxLinkage)) / lq;
+
+      torque = 1.5f * polePairs * (fluxLinkage + (ld - lq) * id) * iq;
+
+      if (inertia > 0)
+      {
+         float omegaMech = omega / polePairs;
+         omegaMech += dt * (torque - loadTorque - friction * omegaMech) / inertia;
+         omega = omegaMech * polePairs;
+      }
+
+      angle += omega * dt;
+      if (angle >= TWO_PI) angle -= TWO_PI;
+      else if (angle < 0) angle += TWO_PI;
+
+      //Power balance, inverter losses neglected
+      idc = u > 0 ? 1.5f * (ud * id + uq * iq) / (u * pwmRange) : 0;
+   }
+
+   float sin = sinf(angle);
+   float cos = cosf(angle);
+   float ialpha = cos * id - sin * iq;
+   float ibeta = sin * id + cos * iq;
+   il1 = ialpha;
+   il2 = -0.5f * ialpha + 0.866025404f * ibeta;
+}
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "profiler.h"
+#include "printf.h"
+#include "terminal.h"
+#include "my_string.h"
+
+#if PROFILING
+
+struct ProbeDescriptor
+{
+   const char* name;
+   Param::PARAM_NUM avgParam;
+   Param::PARAM_NUM maxParam;
+};
+
+#define PROFILE_ENTRY(name, avgParam, maxParam) { #name, avgParam, maxParam },
+static const struct ProbeDescriptor probeDescriptors[] =
+{
+   PROFILE_LIST
+};
+#undef PROFILE_ENTRY
+
+Profiler::Probe Profiler::probes[PROFILE_LAST];
+
+void Profiler::Init()
+{
+   hal_cycle_counter_enable();
+   Reset();
+}
+
+void Profiler::Publish()
+{
+   for (int i = 0; i < PROFILE_LAST; i++)
+   {
+      Probe& p = probes[i];
+      //A sample recorded by an interrupt in between is lost, harmless for statistics
+      uint32_t count = p.count;
+      uint32_t sum = p.sum;
+      p.count = 0;
+      p.sum = 0;
+
+      if (count > 0)
+         p.avg = sum / count;
+
+      if (probeDescriptors[i].avgParam != Param::PARAM_INVALID)
+         Param::SetInt(probeDescriptors[i].avgParam, p.avg);
+      if (probeDescriptors[i].maxParam != Param::PARAM_INVALID)
+         Param::SetInt(probeDescriptors[i].maxParam, p.max);
+   }
+}
+
+void Profiler::Reset()
+{
+   for (int i = 0; i < PROFILE_LAST; i++)
+   {
+      probes[i].min = 0xFFFFFFFF;
+      probes[i].max = 0;
+   }
+}
+
+void Profiler::PrintTable(Terminal* term, char* arg)
+{
+   arg = my_trim(arg);
+
+   if (my_strcmp(arg, "reset") == 0)
+   {
+      Reset();
+      fprintf(term, "Profile reset\r\n");
+      return;
+   }
+
+   fprintf(term, "probe\tmin\tmax\tavg\r\n");
+
+   for (int i = 0; i < PROFILE_LAST; i++)
+   {
+      const Probe& p = probes[i];
+      fprintf(term, "%s\t%u\t%u\t%u\r\n", probeDescriptors[i].name, p.max > 0 ? p.min : 0, p.max, p.avg);
+   }
+}
+
+#else
+
+void Profiler::Init() {}
+void Profiler::Publish() {}
+void Profiler::Reset() {}
+
+void Profiler::PrintTable(Terminal* term, char* arg)
+{
+   (void)arg;
+   fprintf(term, "Profiling disabled, build with PROFILING=1\r\n");
+}
+
+#endif // PROFILING
@@ -20,29 +20,63 @@
   * @{
  */
 #include "sine_core.h"
+#include "my_math.h"
 
 #define SINTAB_ARGDIGITS 11
 #define SINTAB_ENTRIES  (1 << SINTAB_ARGDIGITS)
 /* Value range of sine lookup table */
-#define SINTAB_MAX      (1 << BITS)
-#define BRAD_PI         (1 << (BITS - 1))
+#define SINTAB_MAX      (1 << SineCore::BITS)
+#define BRAD_PI         (1 << (SineCore::BITS - 1))
 
 #define PHASE_SHIFT90   ((uint32_t)(     SINLU_ONEREV / 4))
 #define PHASE_SHIFT120  ((uint32_t)(     SINLU_ONEREV / 3))
 #define PHASE_SHIFT240  ((uint32_t)(2 * (SINLU_ONEREV / 3)))
+#define DEADTIME_GAIN_DIGITS 16
 
 const uint32_t SineCore::minPulse = 1000;
-uint32_t SineCore::ampl = 0;
 const int16_t SineCore::SinTab[] = { SINTAB };/* sine LUT */
+/* atan(i/256) for i = 0..256, 65536 = 90° */
+const uint16_t SineCore::AtanTab[] =
+{
+   0, 163, 326, 489, 652, 815, 978, 1141, 1303, 1466, 1629, 1792,
+   1954, 2117, 2279, 2442, 2604, 2767, 2929, 3091, 3253, 3415, 3577, 3738,
+   3900, 4061, 4223, 4384, 4545, 4706, 4867, 5028, 5188, 5349, 5509, 5669,
+   5829, 5989, 6148, 6308, 6467, 6626, 6784, 6943, 7101, 7260, 7418, 7575,
+   7733, 7890, 8047, 8204, 8361, 8517, 8673, 8829, 8985, 9140, 9296, 9450,
+   9605, 9759, 9914, 10067, 10221, 10374, 10527, 10680, 10832, 10984, 11136, 11287,
+   11439, 11590, 11740, 11890, 12040, 12190, 12339, 12488, 12637, 12785, 12933, 13081,
+   13228, 13375, 13522, 13668, 13814, 13959, 14105, 14249, 14394, 14538, 14682, 14825,
+   14968, 15111, 15253, 15395, 15537, 15678, 15819, 15960, 16100, 16239, 16379, 16518,
+   16656, 16794, 16932, 17069, 17206, 17343, 17479, 17615, 17750, 17885, 18020, 18154,
+   18288, 18421, 18554, 18687, 18819, 18951, 19083, 19213, 19344, 19474, 19604, 19733,
+   19862, 19991, 20119, 20247, 20374, 20501, 20627, 20753, 20879, 21004, 21129, 21254,
+   21378, 21501, 21624, 21747, 21870, 21992, 22113, 22234, 22355, 22475, 22595, 22714,
+   22834, 22952, 23070, 23188, 23306, 23423, 23539, 23655, 23771, 23886, 24001, 24116,
+   24230, 24344, 24457, 24570, 24682, 24795, 24906, 25017, 25128, 25239, 25349, 25459,
+   25568, 25677, 25785, 25893, 26001, 26108, 26215, 26321, 26427, 26533, 26638, 26743,
+   26848, 26952, 27056, 27159, 27262, 27364, 27467, 27568, 27670, 27771, 27871, 27972,
+   28072, 28171, 28270, 28369, 28467, 28565, 28663, 28760, 28857, 28953, 29050, 29145,
+   29241, 29336, 29430, 29525, 29619, 29712, 29805, 29898, 29991, 30083, 30175, 30266,
+   30357, 30448, 30538, 30628, 30718, 30807, 30896, 30985, 31073, 31161, 31248, 31336,
+   31423, 31509, 31595, 31681, 31767, 31852, 31937, 32022, 32106, 32190, 32273, 32357,
+   32439, 32522, 32604, 32686, 32768
+};
 const uint16_t SineCore::ZERO_OFFSET = SINTAB_MAX / 2;
 const int SineCore::BITS = 16;
 const uint16_t SineCore::MAXAMP = 37813;
-uint32_t SineCore::DutyCycles[3];
+SineChannel SineCore::defaultChannel;
+uint32_t (&SineCore::DutyCycles)[3] = SineCore::defaultChannel.DutyCycles;
+
+SineChannel::SineChannel()
+ : ampl(0), pwmMode(PwmMode::SVPWM), il1(0), il2(0), dtBand(0), dtGain(0)
+{
+   DutyCycles[0] = DutyCycles[1] = DutyCycles[2] = 0;
+}
 
 /** Calculate the next dutycyles.
   * This function is meant to be called by your timer interrupt handler
   */
-void SineCore::Calc(uint16_t angle)
+void SineChannel::Calc(uint16_t angle)
 {
     int32_t Ofs;
     uint32_t Idx;
@@ -50,37 +84,58 @@ void SineCore::Calc(uint16_t angle)
     int32_t sine[3];
 
     /* 1. Calculate sine */
-    sine[0] = SineLookup(angle);
-    sine[1] = SineLookup((angle + PHASE_SHIFT120) & 0xFFFF);
-    sine[2] = SineLookup((angle + PHASE_SHIFT240) & 0xFFFF);
+    sine[0] = SineCore::SineLookup(angle);
+    sine[1] = SineCore::SineLookup((angle + PHASE_SHIFT120) & 0xFFFF);
+    sine[2] = SineCore::SineLookup((angle + PHASE_SHIFT240) & 0xFFFF);
 
     for (Idx = 0; Idx < 3; Idx++)
     {
        /* 2. Set desired amplitude  */
-       sine[Idx] = MultiplyAmplitude(ampl, sine[Idx]);
+       sine[Idx] = SineCore::MultiplyAmplitude(ampl, sine[Idx]);
     }
 
-    /* 3. Calculate the offset of SVPWM */
-    Ofs = CalcSVPWMOffset(sine[0], sine[1], sine[2]);
+    /* 3. Calculate the offset of SVPWM or DPWM.
+     * Phase 2 leads phase 1 here, so pass the phases in positive sequence */
+    Ofs = SineCore::CalcPWMOffset(sine[0], sine[2], sine[1], SineCore::ZERO_OFFSET, pwmMode);
+
+    if (dtGain != 0)
+    {
+       sine[0] += SineCore::DeadTimeCompensation(il1, dtBand, dtGain);
+       sine[1] += SineCore::DeadTimeCompensation(il2, dtBand, dtGain);
+       sine[2] += SineCore::DeadTimeCompensation(-il1 - il2, dtBand, dtGain);
+    }
 
     for (Idx = 0; Idx < 3; Idx++)
     {
        /* 4. subtract it from all 3 phases -> no difference in phase-to-phase voltage */
        sine[Idx] -= Ofs;
-       /* Shift above 0 */
-       DutyCycles[Idx] = sine[Idx] + ZERO_OFFSET;
+       /* Shift above 0. Dead time correction may push it below, so stay signed until clamped */
+       int32_t duty = sine[Idx] + SineCore::ZERO_OFFSET;
        /* Short pulse supression */
-       if (DutyCycles[Idx] < minPulse)
+       if (duty < (int32_t)SineCore::minPulse)
        {
-          DutyCycles[Idx] = 0U;
+          duty = 0;
        }
-       else if (DutyCycles[Idx] > (SINTAB_MAX - minPulse))
+       else if (duty > (int32_t)(SINTAB_MAX - SineCore::minPulse))
        {
-          DutyCycles[Idx] = SINTAB_MAX;
+          duty = SINTAB_MAX;
        }
+       DutyCycles[Idx] = duty;
     }
 }
 
+/** Enable dead time compensation
+  * @param comp duty cycle correction at large currents in digit, 0 disables compensation
+  * @param band current below which the correction is reduced linearly, avoids
+  *        chattering around current zero crossings. Same scale as the phase currents
+  * @pre SetPhaseCurrents() must be called before every Calc()
+  */
+void SineChannel::SetDeadTimeCompensation(int32_t comp, s32fp band)
+{
+   dtBand = band;
+   dtGain = SineCore::CalcDeadTimeGain(comp, band);
+}
+
 s32fp SineCore::Sine(uint16_t angle)
 {
    return SineLookup(angle);
@@ -136,15 +191,51 @@ uint16_t SineCore::Atan2(int32_t x, int32_t y)
    return phi + ((dphi+2)>>2);
 }
 
-/** Set amplitude of the synthesized sine wave */
-void SineCore::SetAmp(uint32_t amp /**< amplitude in digit. Largest value is 37813 */)
+/** Calculate angle of a vector by table lookup.
+  * Reduces the vector to the first octant, divides the smaller by the larger
+  * component and interpolates atan() in a 257 entry table. Within 0.8 digits
+  * against 1.4 for Atan2() and valid for the full input range. It costs
+  * about the same as Atan2(): both need one division, this one needs one
+  * multiplication instead of six but 514 bytes of table
+  * @param x cosine component, full 32 bit range
+  * @param y sine component, full 32 bit range
+  * @return angle 0..65535 = 0..360°
+  */
+uint16_t SineCore::Atan2Table(int32_t x, int32_t y)
 {
-   ampl = amp;
-}
+   uint32_t ax = x < 0 ? 0U - (uint32_t)x : (uint32_t)x;
+   uint32_t ay = y < 0 ? 0U - (uint32_t)y : (uint32_t)y;
+   uint32_t num = ay < ax ? ay : ax;
+   uint32_t den = ay < ax ? ax : ay;
 
-uint32_t SineCore::GetAmp()
-{
-   return ampl;
+   if (den == 0)
+      return 0;
+
+   //Keep the dividend within 31 bits, ratio has 15 fractional bits
+   int shift = 16 - __builtin_clz(den);
+
+   if (shift > 0)
+   {
+      num >>= shift;
+      den >>= shift;
+   }
+
+   uint32_t t = ((num << 15) + den / 2) / den;
+   uint32_t idx = t >> 7;
+   uint32_t frac = t & 0x7F;
+   uint32_t phi = AtanTab[idx];
+
+   if (frac != 0)
+      phi += ((AtanTab[idx + 1] - phi) * frac) >> 7;
+
+   //Table is 4x the angle resolution, round to digits
+   phi = (phi + 2) >> 2;
+
+   if (ay > ax) phi = 16384 - phi;
+   if (x < 0) phi = 32768 - phi;
+   if (y < 0) phi = 65536 - phi;
+
+   return phi;
 }
 
 /* Performs a lookup in the sine table */
@@ -178,6 +269,90 @@ int32_t SineCore::CalcSVPWMOffset(int32_t a, int32_t b, int32_t c)
     return (Offset >> 1);
 }
 
+/** Calculate zero sequence offset for given modulation mode
+ * The phases must be given in positive sequence, i.e. b lags a by 120° and
+ * c lags b by 120°, otherwise DPWM0 and DPWM2 are swapped
+ * \param a phase 1 voltage
+ * \param b phase voltage lagging a by 120°
+ * \param c phase voltage lagging b by 120°
+ * \param halfRange half of the duty cycle range, i.e. the offset that shifts 0 to 50% duty
+ * \param mode modulation mode
+ * \return offset to be subtracted from all three phases
+ */
+int32_t SineCore::CalcPWMOffset(int32_t a, int32_t b, int32_t c, int32_t halfRange, PwmMode::PwmMode mode)
+{
+    int32_t clamped, x, y, z;
+
+    switch (mode)
+    {
+    case PwmMode::DPWMMIN:
+        return min(min(a, b), c) + halfRange;
+    case PwmMode::DPWMMAX:
+        return max(max(a, b), c) - halfRange;
+    case PwmMode::DPWM0:
+        /* a - b leads a by 30° in positive sequence */
+        x = a - b;
+        y = b - c;
+        z = c - a;
+        break;
+    case PwmMode::DPWM2:
+        /* a - c lags a by 30° in positive sequence */
+        x = a - c;
+        y = b - a;
+        z = c - b;
+        break;
+    case PwmMode::DPWM1:
+        x = a;
+        y = b;
+        z = c;
+        break;
+    default:
+        return CalcSVPWMOffset(a, b, c);
+    }
+
+    /* Clamp the phase whose (shifted) voltage has the largest magnitude */
+    clamped = a;
+
+    if (ABS(y) > ABS(x) && ABS(y) >= ABS(z))
+    {
+        x = y;
+        clamped = b;
+    }
+    else if (ABS(z) > ABS(x))
+    {
+        x = z;
+        clamped = c;
+    }
+
+    return x > 0 ? clamped - halfRange : clamped + halfRange;
+}
+
+/** Precompute slope of dead time compensation within the transition band
+ * \param comp full correction in digit
+ * \param band current at which the full correction is reached
+ * \return gain to be passed to DeadTimeCompensation(), 0 if disabled
+ */
+int32_t SineCore::CalcDeadTimeGain(int32_t comp, s32fp band)
+{
+    if (band <= 0) return 0;
+    return (comp << DEADTIME_GAIN_DIGITS) / band;
+}
+
+/** Calculate dead time correction of one phase.
+ * Positive current makes the phase voltage lose the dead time, so the
+ * duty cycle is extended by the correction and vice versa.
+ * \param current phase current, positive flowing into the motor
+ * \param band transition band, see CalcDeadTimeGain()
+ * \param gain precomputed by CalcDeadTimeGain()
+ * \return duty cycle correction
+ */
+int32_t SineCore::DeadTimeCompensation(s32fp current, s32fp band, int32_t gain)
+{
+    current = MIN(current, band);
+    current = MAX(current, -band);
+    return (current * gain) >> DEADTIME_GAIN_DIGITS;
+}
+
 int32_t SineCore::min(int32_t a, int32_t b)
 {
    return (a <= b)?a:b;
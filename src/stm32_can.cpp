@@ -22,18 +22,13 @@
 #include "my_string.h"
 #include "my_math.h"
 #include "printf.h"
-#include <libopencm3/stm32/can.h>
-#include <libopencm3/stm32/gpio.h>
-#include <libopencm3/stm32/rcc.h>
-#include <libopencm3/stm32/flash.h>
-#include <libopencm3/stm32/crc.h>
-#include <libopencm3/stm32/rtc.h>
-#include <libopencm3/cm3/common.h>
-#include <libopencm3/cm3/nvic.h>
+#include "hal_can.h"
+#include "hal_flash.h"
+#include "hal_system.h"
 #include "stm32_can.h"
 
 #define MAX_INTERFACES        2
-#define IDS_PER_BANK          4
+#define IDS_PER_BANK          HAL_CAN_FILTERS_PER_BANK
 #define SDO_WRITE             0x40
 #define SDO_READ              0x22
 #define SDO_ABORT             0x80
@@ -41,6 +36,7 @@
 #define SDO_READ_REPLY        0x43
 #define SDO_ERR_INVIDX        0x06020000
 #define SDO_ERR_RANGE         0x06090030
+#define EMCY_BASEID           0x80
 #define SENDMAP_ADDRESS       CANMAP_ADDRESS
 #define RECVMAP_ADDRESS       (CANMAP_ADDRESS + sizeof(canSendMap))
 #define CRC_ADDRESS           (CANMAP_ADDRESS + sizeof(canSendMap) + sizeof(canRecvMap))
@@ -63,6 +59,13 @@ struct CAN_SDO
    uint32_t data;
 } __attribute__((packed));
 
+struct CAN_EMCY
+{
+   uint16_t errorCode;
+   uint8_t errorRegister;
+   uint8_t manufacturer[5];
+} __attribute__((packed));
+
 struct CANSPEED
 {
    uint32_t ts1;
@@ -90,9 +93,9 @@ static const CANSPEED canSpeed[Can::BaudLast] =
  * \param gain Fixed point gain to be multiplied before sending
  * \return success: number of active messages
  * Fault:
- * - CAN_ERR_INVALID_ID ID was > 0x7ff
- * - CAN_ERR_INVALID_OFS Offset > 63
- * - CAN_ERR_INVALID_LEN Length > 32
+ * - CAN_ERR_INVALID_ID ID was < 0 or > 0x7ff
+ * - CAN_ERR_INVALID_OFS Offset < 0 or > 63
+ * - CAN_ERR_INVALID_LEN Length < 1, > 32 or exceeding bit 63
  * - CAN_ERR_MAXMESSAGES Already 10 send messages defined
  * - CAN_ERR_MAXITEMS Already 8 items in message
  */
@@ -110,9 +113,9 @@ int Can::AddSend(Param::PARAM_NUM param, int canId, int offset, int length, s16f
  * \param gain Fixed point gain to be multiplied after receiving
  * \return success: number of active messages
  * Fault:
- * - CAN_ERR_INVALID_ID ID was > 0x7ff
- * - CAN_ERR_INVALID_OFS Offset > 63
- * - CAN_ERR_INVALID_LEN Length > 32
+ * - CAN_ERR_INVALID_ID ID was < 0 or > 0x7ff
+ * - CAN_ERR_INVALID_OFS Offset < 0 or > 63
+ * - CAN_ERR_INVALID_LEN Length < 1, > 32 or exceeding bit 63
  * - CAN_ERR_MAXMESSAGES Already 10 receive messages defined
  * - CAN_ERR_MAXITEMS Already 8 items in message
  */
@@ -192,11 +195,11 @@ bool Can::FindMap(Param::PARAM_NUM param, int& canId, int& offset, int& length,
 void Can::Save()
 {
    uint32_t crc;
-   crc_reset();
+   hal_crc_reset();
 
-   flash_unlock();
-   flash_set_ws(2);
-   flash_erase_page(CANMAP_ADDRESS);
+   hal_flash_unlock();
+   hal_flash_set_ws(2);
+   hal_flash_erase_page(CANMAP_ADDRESS);
 
    ReplaceParamEnumByUid(canSendMap);
    ReplaceParamEnumByUid(canRecvMap);
@@ -204,7 +207,7 @@ void Can::Save()
    SaveToFlash(SENDMAP_ADDRESS, (uint32_t *)canSendMap, SENDMAP_WORDS);
    crc = SaveToFlash(RECVMAP_ADDRESS, (uint32_t *)canRecvMap, RECVMAP_WORDS);
    SaveToFlash(CRC_ADDRESS, &crc, 1);
-   flash_lock();
+   hal_flash_lock();
 
    ReplaceParamUidByEnum(canSendMap);
    ReplaceParamUidByEnum(canRecvMap);
@@ -220,14 +223,31 @@ void Can::SendAll()
 
       forEachPosMap(curPos, curMap)
       {
-         s32fp val = Param::Get((Param::PARAM_NUM)curPos->mapParam);
+         Param::PARAM_NUM param = (Param::PARAM_NUM)curPos->mapParam;
+         s32fp val;
 
-         if (curPos->gain <= 32 && curPos->gain >= -32)
-            val = FP_MUL(val, curPos->gain);
+         if (Param::GetKind(param) == Param::KIND_FIXED)
+         {
+            val = Param::Get(param);
+
+            //64 bit product, only the low numBits are sent and must not depend on overflow
+            if (curPos->gain <= 32 && curPos->gain >= -32)
+               val = ((int64_t)val * curPos->gain) >> FRAC_DIGITS;
+            else
+               val /= curPos->gain;
+         }
          else
-            val /= curPos->gain;
+         {
+            //Same scaling on the raw integer, Get() would saturate beyond 2^26
+            val = Param::GetRaw(param);
+
+            if (curPos->gain <= 32 && curPos->gain >= -32)
+               val = (int64_t)val * curPos->gain;
+            else
+               val = ((int64_t)val << FRAC_DIGITS) / curPos->gain;
+         }
 
-         val &= ((1 << curPos->numBits) - 1);
+         val &= 0xFFFFFFFF >> (32 - curPos->numBits); //numBits may be 32
 
          if (curPos->offsetBits > 31)
          {
@@ -283,50 +303,26 @@ Can::Can(uint32_t baseAddr, enum baudrates baudrate)
    Clear();
    LoadFromFlash();
 
+   hal_can_setup_pins(baseAddr);
+
    switch (baseAddr)
    {
       case CAN1:
-         // Configure CAN pin: RX (input pull-up).
-         gpio_set_mode(GPIO_BANK_CAN1_RX, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_CAN1_RX);
-         gpio_set(GPIO_BANK_CAN1_RX, GPIO_CAN1_RX);
-         // Configure CAN pin: TX.-
-         gpio_set_mode(GPIO_BANK_CAN1_TX, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_CAN1_TX);
-         //CAN1 RX and TX IRQs
-         nvic_enable_irq(NVIC_USB_LP_CAN_RX0_IRQ); //CAN RX
-         nvic_set_priority(NVIC_USB_LP_CAN_RX0_IRQ, 0xf << 4); //lowest priority
-         nvic_enable_irq(NVIC_CAN_RX1_IRQ); //CAN RX
-         nvic_set_priority(NVIC_CAN_RX1_IRQ, 0xf << 4); //lowest priority
-         nvic_enable_irq(NVIC_USB_HP_CAN_TX_IRQ); //CAN TX
-         nvic_set_priority(NVIC_USB_HP_CAN_TX_IRQ, 0xf << 4); //lowest priority
          interfaces[0] = this;
          break;
       case CAN2:
-         // Configure CAN pin: RX (input pull-up).
-         gpio_set_mode(GPIO_BANK_CAN2_RX, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_CAN2_RX);
-         gpio_set(GPIO_BANK_CAN2_RX, GPIO_CAN2_RX);
-         // Configure CAN pin: TX.-
-         gpio_set_mode(GPIO_BANK_CAN2_TX, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_CAN2_TX);
-
-         //CAN2 RX and TX IRQs
-         nvic_enable_irq(NVIC_CAN2_RX0_IRQ); //CAN RX
-         nvic_set_priority(NVIC_CAN2_RX0_IRQ, 0xf << 4); //lowest priority
-         nvic_enable_irq(NVIC_CAN2_RX1_IRQ); //CAN RX
-         nvic_set_priority(NVIC_CAN2_RX1_IRQ, 0xf << 4); //lowest priority
-         nvic_enable_irq(NVIC_CAN2_TX_IRQ); //CAN RX
-         nvic_set_priority(NVIC_CAN2_TX_IRQ, 0xf << 4); //lowest priority
          interfaces[1] = this;
          break;
    }
 
    nodeId = 1;
 	// Reset CAN
-	can_reset(canDev);
+	hal_can_reset(canDev);
 
 	SetBaudrate(baudrate);
    ConfigureFilters();
 	// Enable CAN RX interrupts.
-	can_enable_irq(canDev, CAN_IER_FMPIE0);
-	can_enable_irq(canDev, CAN_IER_FMPIE1);
+	hal_can_enable_rx_irq(canDev);
 }
 
 /** \brief Set baud rate to given value
@@ -343,19 +339,7 @@ void Can::SetBaudrate(enum baudrates baudrate)
 	 // 1tq sync + 9tq bit segment1 (TS1) + 6tq bit segment2 (TS2) =
 	 // 16time quanto per bit period, therefor 4MHz/16 = 250kHz
 	 //
-	can_init(canDev,
-		     false,          // TTCM: Time triggered comm mode?
-		     true,           // ABOM: Automatic bus-off management?
-		     false,          // AWUM: Automatic wakeup mode?
-		     false,          // NART: No automatic retransmission?
-		     false,          // RFLM: Receive FIFO locked mode?
-		     false,          // TXFP: Transmit FIFO priority?
-		     CAN_BTR_SJW_1TQ,
-		     canSpeed[baudrate].ts1,
-		     canSpeed[baudrate].ts2,
-		     canSpeed[baudrate].prescaler,				// BRP+1: Baud rate prescaler
-		     false,
-		     false);
+	hal_can_init(canDev, canSpeed[baudrate].ts1, canSpeed[baudrate].ts2, canSpeed[baudrate].prescaler);
 }
 
 /** \brief Get RTC time when last message was received
@@ -378,9 +362,9 @@ uint32_t Can::GetLastRxTimestamp()
  */
 void Can::Send(uint32_t canId, uint32_t data[2], uint8_t len)
 {
-   can_disable_irq(canDev, CAN_IER_TMEIE);
+   hal_can_enable_tx_irq(canDev, false);
 
-   if (can_transmit(canDev, canId, false, false, len, (uint8_t*)data) < 0 && sendCnt < SENDBUFFER_LEN)
+   if (hal_can_transmit(canDev, canId, len, data) < 0 && sendCnt < SENDBUFFER_LEN)
    {
       /* enqueue in send buffer if all TX mailboxes are full */
       sendBuffer[sendCnt].id = canId;
@@ -392,7 +376,7 @@ void Can::Send(uint32_t canId, uint32_t data[2], uint8_t len)
 
    if (sendCnt > 0)
    {
-      can_enable_irq(canDev, CAN_IER_TMEIE);
+      hal_can_enable_tx_irq(canDev, true);
    }
 }
 
@@ -426,11 +410,10 @@ Can* Can::GetInterface(int index)
 void Can::HandleRx(int fifo)
 {
    uint32_t id;
-	bool ext, rtr;
-	uint8_t length, fmi;
+	uint8_t length;
 	uint32_t data[2];
 
-   while (can_receive(canDev, fifo, true, &id, &ext, &rtr, &fmi, &length, (uint8_t*)data, NULL) > 0)
+   while (hal_can_receive(canDev, fifo, &id, &length, data) > 0)
    {
       //printf("fifo: %d, id: %x, len: %d, data[0]: %x, data[1]: %x\r\n", fifo, id, length, data[0], data[1]);
       if (id == (0x600U + nodeId) && length == 8) //SDO request, nodeid=1
@@ -445,24 +428,41 @@ void Can::HandleRx(int fifo)
          {
             forEachPosMap(curPos, recvMap)
             {
-               s32fp val;
+               Param::PARAM_NUM param = (Param::PARAM_NUM)curPos->mapParam;
+               uint32_t field;
+               int32_t val;
 
                if (curPos->offsetBits > 31)
                {
-                  val = FP_FROMINT((data[1] >> (curPos->offsetBits - 32)) & ((1 << curPos->numBits) - 1));
+                  field = (data[1] >> (curPos->offsetBits - 32)) & (0xFFFFFFFF >> (32 - curPos->numBits));
                }
                else
                {
-                  val = FP_FROMINT((data[0] >> curPos->offsetBits) & ((1 << curPos->numBits) - 1));
+                  field = (data[0] >> curPos->offsetBits) & (0xFFFFFFFF >> (32 - curPos->numBits));
                }
-               val = FP_MUL(val, curPos->gain);
 
-               if (Param::IsParam((Param::PARAM_NUM)curPos->mapParam))
-                  Param::Set((Param::PARAM_NUM)curPos->mapParam, val);
+               if (Param::GetKind(param) == Param::KIND_FIXED)
+               {
+                  val = FP_FROMINT(field);
+                  val = ((int64_t)val * curPos->gain) >> FRAC_DIGITS; //Wide fields overflow 32 bit
+
+                  if (Param::IsParam(param))
+                     Param::Set(param, val, Param::SRC_CAN);
+                  else
+                     Param::SetFlt(param, val);
+               }
                else
-                  Param::SetFlt((Param::PARAM_NUM)curPos->mapParam, val);
+               {
+                  //Same gain on the plain integer, a fixed point detour would lose the top bits
+                  val = ((int64_t)field * curPos->gain) >> FRAC_DIGITS;
+
+                  if (Param::IsParam(param))
+                     Param::SetIntChecked(param, val, Param::SRC_CAN);
+                  else
+                     Param::SetInt(param, val);
+               }
             }
-            lastRxTimestamp = rtc_get_counter_val();
+            lastRxTimestamp = hal_rtc_get_counter();
          }
          else //Now it must be a user message, as filters block everything else
          {
@@ -474,12 +474,12 @@ void Can::HandleRx(int fifo)
 
 void Can::HandleTx()
 {
-   while (sendCnt > 0 && can_transmit(canDev, sendBuffer[sendCnt - 1].id, false, false, sendBuffer[sendCnt - 1].len, (uint8_t*)sendBuffer[sendCnt - 1].data) >= 0)
+   while (sendCnt > 0 && hal_can_transmit(canDev, sendBuffer[sendCnt - 1].id, sendBuffer[sendCnt - 1].len, sendBuffer[sendCnt - 1].data) >= 0)
       sendCnt--;
 
    if (sendCnt == 0)
    {
-      can_disable_irq(canDev, CAN_IER_TMEIE);
+      hal_can_enable_tx_irq(canDev, false);
    }
 }
 
@@ -496,6 +496,29 @@ void Can::SDOWrite(uint8_t remoteNodeId, uint16_t index, uint8_t subIndex, uint3
    Send(0x600 + remoteNodeId, d);
 }
 
+/** \brief Send CiA 301 emergency message
+ * The message is sent on ID 0x80 + node id which has higher priority than
+ * all SDO and most user messages. If all mailboxes are full it is queued
+ * and sent from the TX interrupt.
+ *
+ * \param errorCode CiA 301 emergency error code
+ * \param errorRegister value of the error register (object 0x1001)
+ * \param manufacturer manufacturer specific error field, bytes 3-7 of the frame
+ */
+void Can::SendEmcy(uint16_t errorCode, uint8_t errorRegister, const uint8_t manufacturer[5])
+{
+   uint32_t d[2];
+   CAN_EMCY *emcy = (CAN_EMCY*)d;
+
+   emcy->errorCode = errorCode;
+   emcy->errorRegister = errorRegister;
+
+   for (int i = 0; i < 5; i++)
+      emcy->manufacturer[i] = manufacturer[i];
+
+   Send(EMCY_BASEID + nodeId, d);
+}
+
 /****************** Private methods and ISRs ********************/
 
 //http://www.byteme.org.uk/canopenparent/canopen/sdo-service-data-objects-canopen/
@@ -510,9 +533,22 @@ void Can::ProcessSDO(uint32_t data[2])
       if (sdo->index == 0x2001)
          paramIdx = Param::NumFromId(sdo->subIndex);
 
-      if (sdo->cmd == SDO_WRITE)
+      if (paramIdx == Param::PARAM_INVALID)
+      {
+         sdo->cmd = SDO_ABORT;
+         sdo->data = SDO_ERR_INVIDX;
+      }
+      else if (sdo->cmd == SDO_WRITE)
       {
-         if (Param::Set(paramIdx, sdo->data) == 0)
+         int result;
+
+         //Integer kinds are transferred as plain integers to keep their full range
+         if (Param::GetKind(paramIdx) == Param::KIND_FIXED)
+            result = Param::Set(paramIdx, sdo->data, Param::SRC_SDO);
+         else
+            result = Param::SetIntChecked(paramIdx, sdo->data, Param::SRC_SDO);
+
+         if (result == 0)
          {
             sdo->cmd = SDO_WRITE_REPLY;
          }
@@ -524,10 +560,41 @@ void Can::ProcessSDO(uint32_t data[2])
       }
       else if (sdo->cmd == SDO_READ)
       {
-         sdo->data = Param::Get(paramIdx);
+         sdo->data = Param::GetKind(paramIdx) == Param::KIND_FIXED ? Param::Get(paramIdx) : Param::GetRaw(paramIdx);
          sdo->cmd = SDO_READ_REPLY;
       }
    }
+   else if (sdo->index >= 0x2100 && sdo->index <= 0x2103 && sdo->cmd == SDO_READ)
+   {
+      //Change history, subindex 0 is the most recent change. 0x2100 returns the
+      //parameters unique ID plus source in bits 16-23, 0x2101 old value, 0x2102 new value
+      //and 0x2103 the timestamp. Values are in storage format, see Param::GetRaw()
+      Param::HistoryEntry entry;
+
+      if (Param::GetHistory(sdo->subIndex, entry))
+      {
+         switch (sdo->index)
+         {
+            case 0x2100:
+               sdo->data = Param::GetId((Param::PARAM_NUM)entry.param) | (entry.source << 16);
+               break;
+            case 0x2101:
+               sdo->data = entry.oldVal;
+               break;
+            case 0x2102:
+               sdo->data = entry.newVal;
+               break;
+            default:
+               sdo->data = entry.time;
+         }
+         sdo->cmd = SDO_READ_REPLY;
+      }
+      else
+      {
+         sdo->cmd = SDO_ABORT;
+         sdo->data = SDO_ERR_INVIDX;
+      }
+   }
    else if (sdo->index >= 0x3000 && sdo->index < 0x4800 && sdo->subIndex < Param::PARAM_LAST)
    {
       if (sdo->cmd == SDO_WRITE)
@@ -567,14 +634,7 @@ void Can::ProcessSDO(uint32_t data[2])
 
 void Can::SetFilterBank(int& idIndex, int& filterId, uint16_t* idList)
 {
-   can_filter_id_list_16bit_init(
-         filterId,
-         idList[0] << 5, //left align
-         idList[1] << 5,
-         idList[2] << 5,
-         idList[3] << 5,
-         filterId & 1,
-         true);
+   hal_can_filter_id_list(filterId, idList, filterId & 1);
    idIndex = 0;
    filterId++;
    idList[0] = idList[1] = idList[2] = idList[3] = 0;
@@ -584,7 +644,7 @@ void Can::ConfigureFilters()
 {
    uint16_t idList[IDS_PER_BANK] = { 0, 0, 0, 0 };
    int idIndex = 1;
-   int filterId = canDev == CAN1 ? 0 : ((CAN_FMR(CAN2) >> 8) & 0x3F);
+   int filterId = hal_can_first_filter(canDev);
 
    idList[0] = 0x600 + nodeId;
 
@@ -618,17 +678,17 @@ void Can::ConfigureFilters()
 
 int Can::LoadFromFlash()
 {
-   uint32_t* data = (uint32_t *)CANMAP_ADDRESS;
-   uint32_t storedCrc = *(uint32_t*)CRC_ADDRESS;
+   const uint32_t* data = hal_flash_pointer(CANMAP_ADDRESS);
+   uint32_t storedCrc = *hal_flash_pointer(CRC_ADDRESS);
    uint32_t crc;
 
-   crc_reset();
-   crc = crc_calculate_block(data, SENDMAP_WORDS + RECVMAP_WORDS);
+   hal_crc_reset();
+   crc = hal_crc_calculate_block(data, SENDMAP_WORDS + RECVMAP_WORDS);
 
    if (storedCrc == crc)
    {
-      memcpy32((int*)canSendMap, (int*)SENDMAP_ADDRESS, SENDMAP_WORDS);
-      memcpy32((int*)canRecvMap, (int*)RECVMAP_ADDRESS, RECVMAP_WORDS);
+      memcpy32((int*)canSendMap, (int*)hal_flash_pointer(SENDMAP_ADDRESS), SENDMAP_WORDS);
+      memcpy32((int*)canRecvMap, (int*)hal_flash_pointer(RECVMAP_ADDRESS), RECVMAP_WORDS);
       ReplaceParamUidByEnum(canSendMap);
       ReplaceParamUidByEnum(canRecvMap);
       return 1;
@@ -650,9 +710,10 @@ int Can::RemoveFromMap(CANIDMAP *canMap, Param::PARAM_NUM param)
 
 int Can::Add(CANIDMAP *canMap, Param::PARAM_NUM param, int canId, int offset, int length, s16fp gain)
 {
-   if (canId > 0x7ff) return CAN_ERR_INVALID_ID;
-   if (offset > 63) return CAN_ERR_INVALID_OFS;
-   if (length > 32) return CAN_ERR_INVALID_LEN;
+   if (canId < 0 || canId > 0x7ff) return CAN_ERR_INVALID_ID;
+   if (offset < 0 || offset > 63) return CAN_ERR_INVALID_OFS;
+   //length <= 0 would be taken as free item or end marker
+   if (length <= 0 || length > 32 || (offset + length) > 64) return CAN_ERR_INVALID_LEN;
 
    CANIDMAP *existingMap = FindById(canMap, canId);
 
@@ -714,8 +775,8 @@ uint32_t Can::SaveToFlash(uint32_t baseAddress, uint32_t* data, int len)
 
    for (int idx = 0; idx < len; idx++)
    {
-      crc = crc_calculate(*data);
-      flash_program_word(baseAddress + idx * sizeof(uint32_t), *data);
+      crc = hal_crc_calculate(*data);
+      hal_flash_program_word(baseAddress + idx * sizeof(uint32_t), *data);
       data++;
    }
 
@@ -761,8 +822,7 @@ void Can::ReplaceParamEnumByUid(CANIDMAP *canMap)
    {
       forEachPosMap(curPos, curMap)
       {
-         const Param::Attributes* attr = Param::GetAttrib((Param::PARAM_NUM)curPos->mapParam);
-         curPos->mapParam = (uint16_t)attr->id;
+         curPos->mapParam = (uint16_t)Param::GetId((Param::PARAM_NUM)curPos->mapParam);
       }
    }
 }
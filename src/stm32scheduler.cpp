@@ -18,21 +18,12 @@
  */
 #include "stm32scheduler.h"
 
-/* return CCRc of TIMt */
-#define TIM_CCR(t,c) (*(volatile uint32_t *)(&TIM_CCR1(t) + (c)))
-
-const enum tim_oc_id Stm32Scheduler::ocMap[MAX_TASKS] = { TIM_OC1, TIM_OC2, TIM_OC3, TIM_OC4 };
-
 Stm32Scheduler::Stm32Scheduler(uint32_t timer)
 {
    this->timer = timer;
-   /* Setup timers upcounting and auto preload enable */
-   timer_enable_preload(timer);
-   timer_direction_up(timer);
-   /* Set prescaler to count at 100 kHz = 72 MHz/7200 - 1 */
-   timer_set_prescaler(timer, 719);
-   /* Maximum counter value */
-   timer_set_period(timer, 0xFFFF);
+   /* Setup timers upcounting and auto preload enable,
+    * set prescaler to count at 100 kHz = 72 MHz/7200 - 1 and maximum counter value */
+   hal_timer_setup(timer, 719, 0xFFFF);
 
    for (int i = 0; i < MAX_TASKS; i++)
    {
@@ -47,23 +38,20 @@ void Stm32Scheduler::AddTask(void (*function)(void), uint16_t period)
 {
    if (nextTask >= MAX_TASKS) return;
    /* Disable timer */
-   timer_disable_counter(timer);
-
-   timer_set_oc_mode(timer, ocMap[nextTask], TIM_OCM_ACTIVE);
-   timer_set_oc_value(timer, ocMap[nextTask], 0);
+   hal_timer_enable(timer, false);
 
    /* Assign task function and period */
    functions[nextTask] = function;
    periods  [nextTask] = period * 100;
 
-   /* Enable interrupt for that channel */
-   timer_enable_irq(timer, TIM_DIER_CC1IE << nextTask);
+   /* Compare at 0 and enable interrupt for that channel */
+   hal_timer_setup_compare(timer, nextTask, 0);
 
    /* Reset counter */
-   timer_set_counter(timer, 0);
+   hal_timer_set_counter(timer, 0);
 
    /* Enable timer */
-   timer_enable_counter(timer);
+   hal_timer_enable(timer, true);
 
    nextTask++;
 }
@@ -72,13 +60,13 @@ void Stm32Scheduler::Run()
 {
    for (int i = 0; i < MAX_TASKS; i++)
    {
-      if (timer_get_flag(timer, TIM_SR_CC1IF << i))
+      if (hal_timer_compare_pending(timer, i))
       {
-         uint16_t start = timer_get_counter(timer);
-         timer_clear_flag(timer, TIM_SR_CC1IF << i);
-         TIM_CCR(timer, i) += periods[i];
+         uint16_t start = hal_timer_get_counter(timer);
+         hal_timer_clear_compare(timer, i);
+         hal_timer_advance_compare(timer, i, periods[i]);
          functions[i]();
-         execTicks[i] = timer_get_counter(timer) - start;
+         execTicks[i] = hal_timer_get_counter(timer) - start;
       }
    }
 }
@@ -18,10 +18,8 @@
  */
 
 #include "my_string.h"
-#include <libopencm3/cm3/common.h>
-#include <libopencm3/stm32/usart.h>
-#include <libopencm3/stm32/gpio.h>
-#include <libopencm3/stm32/dma.h>
+#include "hal_gpio.h"
+#include "hal_uart.h"
 #include "terminal.h"
 #include "printf.h"
 
@@ -63,48 +61,27 @@ Terminal::Terminal(uint32_t usart, const TERM_CMD* commands, bool remap)
 
    defaultTerminal = this;
 
-   gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_OUTPUT_50_MHZ,
+   hal_gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_OUTPUT_50_MHZ,
                GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, remap ? hw->pin_re : hw->pin);
 
-   usart_set_baudrate(usart, USART_BAUDRATE);
-   usart_set_databits(usart, 8);
-   usart_set_stopbits(usart, USART_STOPBITS_2);
-   usart_set_mode(usart, USART_MODE_TX_RX);
-   usart_set_parity(usart, USART_PARITY_NONE);
-   usart_set_flow_control(usart, USART_FLOWCONTROL_NONE);
-   usart_enable_rx_dma(usart);
-   usart_enable_tx_dma(usart);
-
-   dma_channel_reset(DMA1, hw->dmatx);
-   dma_set_read_from_memory(DMA1, hw->dmatx);
-   dma_set_peripheral_address(DMA1, hw->dmatx, (uint32_t)&USART_DR(usart));
-   dma_set_peripheral_size(DMA1, hw->dmatx, DMA_CCR_PSIZE_8BIT);
-   dma_set_memory_size(DMA1, hw->dmatx, DMA_CCR_MSIZE_8BIT);
-   dma_enable_memory_increment_mode(DMA1, hw->dmatx);
-
-   dma_channel_reset(DMA1, hw->dmarx);
-   dma_set_peripheral_address(DMA1, hw->dmarx, (uint32_t)&USART_DR(usart));
-   dma_set_peripheral_size(DMA1, hw->dmarx, DMA_CCR_PSIZE_8BIT);
-   dma_set_memory_size(DMA1, hw->dmarx, DMA_CCR_MSIZE_8BIT);
-   dma_enable_memory_increment_mode(DMA1, hw->dmarx);
-   dma_enable_channel(DMA1, hw->dmarx);
+   hal_uart_init(usart, USART_BAUDRATE, hw->dmatx, hw->dmarx);
 
    ResetDMA();
 
-   usart_enable(usart);
+   hal_uart_enable(usart);
 }
 
 /** Run the terminal */
 void Terminal::Run()
 {
-   int numRcvd = dma_get_number_of_data(DMA1, hw->dmarx);
+   int numRcvd = hal_uart_dma_rx_remaining(hw->dmarx);
    int currentIdx = bufSize - numRcvd;
 
    if (0 == numRcvd)
       ResetDMA();
 
    while (lastIdx < currentIdx) //echo
-      usart_send_blocking(usart, inBuf[lastIdx++]);
+      hal_uart_send_blocking(usart, inBuf[lastIdx++]);
 
    if (currentIdx > 0)
    {
@@ -149,7 +126,7 @@ void Terminal::Run()
 
          if (NULL != pCurCmd)
          {
-            usart_wait_send_ready(usart);
+            hal_uart_wait_send_ready(usart);
             pCurCmd->CmdFunc(this, args);
          }
          else if (currentIdx > 1 && enabled)
@@ -190,19 +167,15 @@ void Terminal::PutChar(char c)
 {
    if (!txDmaEnabled)
    {
-      usart_send_blocking(usart, c);
+      hal_uart_send_blocking(usart, c);
    }
    else if (c == '\n' || curIdx == (bufSize - 1))
    {
       outBuf[curBuf][curIdx] = c;
 
-      while (!dma_get_interrupt_flag(DMA1, hw->dmatx, DMA_TCIF) && !firstSend);
+      while (!hal_uart_dma_tx_done(hw->dmatx) && !firstSend);
 
-      dma_disable_channel(DMA1, hw->dmatx);
-      dma_set_number_of_data(DMA1, hw->dmatx, curIdx + 1);
-      dma_set_memory_address(DMA1, hw->dmatx, (uint32_t)outBuf[curBuf]);
-      dma_clear_interrupt_flags(DMA1, hw->dmatx, DMA_TCIF);
-      dma_enable_channel(DMA1, hw->dmatx);
+      hal_uart_dma_tx_start(hw->dmatx, outBuf[curBuf], curIdx + 1);
 
       curBuf = !curBuf; //switch buffers
       firstSend = false; //only needed once so we don't get stuck in the while loop above
@@ -217,27 +190,23 @@ void Terminal::PutChar(char c)
 
 bool Terminal::KeyPressed()
 {
-   return usart_get_flag(usart, USART_SR_RXNE);
+   return hal_uart_rx_ready(usart);
 }
 
 void Terminal::FlushInput()
 {
-   usart_recv(usart);
+   hal_uart_recv(usart);
 }
 
 void Terminal::DisableTxDMA()
 {
    txDmaEnabled = false;
-   dma_disable_channel(DMA1, hw->dmatx);
-   usart_disable_tx_dma(usart);
+   hal_uart_disable_tx_dma(usart, hw->dmatx);
 }
 
 void Terminal::ResetDMA()
 {
-   dma_disable_channel(DMA1, hw->dmarx);
-   dma_set_memory_address(DMA1, hw->dmarx, (uint32_t)inBuf);
-   dma_set_number_of_data(DMA1, hw->dmarx, bufSize);
-   dma_enable_channel(DMA1, hw->dmarx);
+   hal_uart_dma_rx_start(hw->dmarx, inBuf, bufSize);
 }
 
 void Terminal::EnableUart(char* arg)
@@ -248,14 +217,14 @@ void Terminal::EnableUart(char* arg)
    if (val == nodeId)
    {
       enabled = true;
-      gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_OUTPUT_50_MHZ,
+      hal_gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_OUTPUT_50_MHZ,
                GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, remap ? hw->pin_re : hw->pin);
       Send("OK\r\n");
    }
    else
    {
       enabled = false;
-      gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_INPUT,
+      hal_gpio_set_mode(remap ? hw->port_re : hw->port, GPIO_MODE_INPUT,
                GPIO_CNF_INPUT_FLOAT, remap ? hw->pin_re : hw->pin);
    }
 }
@@ -269,8 +238,7 @@ void Terminal::FastUart(char *arg)
       Send("OK\r\n");
       Send("Baud rate now 921600\r\n");
    }
-   usart_set_baudrate(usart, baud);
-   usart_set_stopbits(usart, USART_STOPBITS_1);
+   hal_uart_set_format(usart, baud, 1);
 }
 
 const TERM_CMD* Terminal::CmdLookup(char *buf)
@@ -296,7 +264,7 @@ const TERM_CMD* Terminal::CmdLookup(char *buf)
 void Terminal::Send(const char *str)
 {
    for (;*str > 0; str++)
-       usart_send_blocking(usart, *str);
+       hal_uart_send_blocking(usart, *str);
 }
 
 //Backward compatibility for printf
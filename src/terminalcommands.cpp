@@ -16,8 +16,8 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <libopencm3/cm3/scb.h>
 #include "hwdefs.h"
+#include "hal_system.h"
 #include "terminal.h"
 #include "params.h"
 #include "my_string.h"
@@ -47,12 +47,27 @@ void TerminalCommands::ParamSet(Terminal* term, char* arg)
    *pParamVal = 0;
    pParamVal++;
 
-   val = fp_atoi(pParamVal, FRAC_DIGITS);
    idx = Param::NumFromString(arg);
 
    if (Param::PARAM_INVALID != idx)
    {
-       if (0 == Param::Set(idx, val))
+       int result;
+
+       if (Param::GetKind(idx) == Param::KIND_FIXED)
+       {
+          val = fp_atoi(pParamVal, FRAC_DIGITS);
+          result = Param::Set(idx, val, Param::SRC_TERMINAL);
+       }
+       else if (Param::GetKind(idx) == Param::KIND_BITFIELD)
+       {
+          result = Param::SetIntChecked(idx, my_atoui(pParamVal), Param::SRC_TERMINAL);
+       }
+       else
+       {
+          result = Param::SetIntChecked(idx, my_atoi(pParamVal), Param::SRC_TERMINAL);
+       }
+
+       if (0 == result)
        {
           fprintf(term, "Set OK\r\n");
        }
@@ -70,7 +85,6 @@ void TerminalCommands::ParamSet(Terminal* term, char* arg)
 void TerminalCommands::ParamGet(Terminal* term, char* arg)
 {
    Param::PARAM_NUM idx;
-   s32fp val;
    char* comma;
    char orig;
 
@@ -86,8 +100,8 @@ void TerminalCommands::ParamGet(Terminal* term, char* arg)
 
       if (Param::PARAM_INVALID != idx)
       {
-         val = Param::Get(idx);
-         fprintf(term, "%f\r\n", val);
+         PrintValue(term, idx, Param::GetRaw(idx));
+         fprintf(term, "\r\n");
       }
       else
       {
@@ -207,8 +221,8 @@ void TerminalCommands::ParamStream(Terminal* term, char *arg)
       comma = (char*)"";
       for (curIndex = 0; curIndex < maxIndex; curIndex++)
       {
-         s32fp val = Param::Get(indexes[curIndex]);
-         fprintf(term, "%s%f", comma, val);
+         fprintf(term, "%s", comma);
+         PrintValue(term, indexes[curIndex], Param::GetRaw(indexes[curIndex]));
          comma = (char*)",";
       }
       fprintf(term, "\r\n");
@@ -235,7 +249,9 @@ void TerminalCommands::PrintParamsJson(Terminal* term, char *arg)
 
       if ((Param::GetFlag((Param::PARAM_NUM)idx) & Param::FLAG_HIDDEN) == 0 || printHidden)
       {
-         fprintf(term, "%c\r\n   \"%s\": {\"unit\":\"%s\",\"value\":%f,",comma, pAtr->name, pAtr->unit, Param::Get((Param::PARAM_NUM)idx));
+         fprintf(term, "%c\r\n   \"%s\": {\"unit\":\"%s\",\"value\":",comma, pAtr->name, pAtr->unit);
+         PrintValue(term, (Param::PARAM_NUM)idx, Param::GetRaw((Param::PARAM_NUM)idx));
+         fprintf(term, ",");
 
          if (Can::GetInterface(0)->FindMap((Param::PARAM_NUM)idx, canId, canOffset, canLength, canGain, isRx))
          {
@@ -245,8 +261,13 @@ void TerminalCommands::PrintParamsJson(Terminal* term, char *arg)
 
          if (Param::IsParam((Param::PARAM_NUM)idx))
          {
-            fprintf(term, "\"isparam\":true,\"minimum\":%f,\"maximum\":%f,\"default\":%f,\"category\":\"%s\",\"i\":%d}",
-                   pAtr->min, pAtr->max, pAtr->def, pAtr->category, idx);
+            fprintf(term, "\"isparam\":true,\"minimum\":");
+            PrintValue(term, (Param::PARAM_NUM)idx, Param::GetMin((Param::PARAM_NUM)idx));
+            fprintf(term, ",\"maximum\":");
+            PrintValue(term, (Param::PARAM_NUM)idx, Param::GetMax((Param::PARAM_NUM)idx));
+            fprintf(term, ",\"default\":");
+            PrintValue(term, (Param::PARAM_NUM)idx, Param::GetDefault((Param::PARAM_NUM)idx));
+            fprintf(term, ",\"category\":\"%s\",\"i\":%d}", pAtr->category, idx);
          }
          else
          {
@@ -338,6 +359,12 @@ void TerminalCommands::MapCan(Terminal* term, char *arg)
       if (i == (numArgs - 1) && iVal == 0)
       {
          values[i] = fp_atoi(arg, 16);
+
+         if (values[i] == 0)
+         {
+            fprintf(term, "Invalid gain\r\n");
+            return;
+         }
          //The can values interprets abs(values) < 32 as gain and > 32 as divider
          //e.g. 0.25 means integer division by 4 so we need to calculate div = 1/value
          //0.25 with 16 decimals is 16384, 65536/16384 = 4
@@ -348,7 +375,8 @@ void TerminalCommands::MapCan(Terminal* term, char *arg)
          values[i] = iVal;
       }
 
-      arg = my_trim(ending + 1);
+      if (i < (numArgs - 1))
+         arg = my_trim(ending + 1);
    }
 
    if (op == 't')
@@ -409,7 +437,58 @@ void TerminalCommands::Reset(Terminal* term, char *arg)
 {
    term = term;
    arg = arg;
-   scb_reset_system();
+   hal_system_reset();
+}
+
+/** Print the parameter change history, newest first. "clear" forgets all entries */
+void TerminalCommands::PrintHistory(Terminal* term, char *arg)
+{
+   static const char* sources[] = { "app", "terminal", "sdo", "can" };
+   Param::HistoryEntry entry;
+
+   arg = my_trim(arg);
+
+   if (my_strcmp(arg, "clear") == 0)
+   {
+      Param::ClearHistory();
+      fprintf(term, "History cleared\r\n");
+      return;
+   }
+
+   if (PARAM_HISTORY_SIZE == 0)
+   {
+      fprintf(term, "History disabled, define PARAM_HISTORY_SIZE\r\n");
+      return;
+   }
+
+   fprintf(term, "time\tsource\tname\told\tnew\r\n");
+
+   for (uint32_t n = 0; Param::GetHistory(n, entry); n++)
+   {
+      Param::PARAM_NUM param = (Param::PARAM_NUM)entry.param;
+
+      fprintf(term, "%u\t%s\t%s\t", entry.time, sources[entry.source], Param::GetAttrib(param)->name);
+      PrintValue(term, param, entry.oldVal);
+      fprintf(term, "\t");
+      PrintValue(term, param, entry.newVal);
+      fprintf(term, "\r\n");
+   }
+}
+
+/** Print a value in storage format according to the parameters kind */
+void TerminalCommands::PrintValue(Terminal* term, Param::PARAM_NUM param, int32_t raw)
+{
+   switch (Param::GetKind(param))
+   {
+      case Param::KIND_FIXED:
+         fprintf(term, "%f", raw);
+         break;
+      case Param::KIND_BITFIELD:
+         fprintf(term, "%u", raw);
+         break;
+      default:
+         fprintf(term, "%d", raw);
+   }
 }
 
 void TerminalCommands::PrintCanMap(Param::PARAM_NUM param, int canid, int offset, int length, s32fp gain, bool rx)
@@ -0,0 +1,286 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "params.h"
+#include "sine_core.h"
+#include "foc.h"
+#include "picontroller.h"
+#include "picontroller64.h"
+#include "picontrollerbank.h"
+#include "pidcontroller.h"
+#include "stm32_can.h"
+#include "hal_can.h"
+#include "hal_adc.h"
+#include "hal_gpio.h"
+#include "anain.h"
+#include "my_fp.h"
+#include "printf.h"
+#include "test.h"
+
+/* Host benchmark of the hot paths. Every line "bench <name> <ns per call>"
+ * is compared against the baseline given on the command line, see README.
+ * Absolute numbers only say something relative to the same host and build */
+
+static volatile int32_t sink;
+static uint16_t angle;
+static Can* can;
+static PiController pi;
+static PiController piSeparate[4];
+static PiController64 pi64Separate[4];
+static PiControllerBank<4> piBank;
+static PidController<false, false, false> pidP;
+static PidController<true, false, false> pidPI;
+static PidController<true, true, false> pidPID;
+static PidController<true, true, true> pidPIDFF;
+static char buf[32];
+
+static void SineCoreCalc()
+{
+   SineCore::Calc(angle += 1000);
+}
+
+static void FocParkClarke()
+{
+   FOC::ParkClarke(FP_FROMINT(100), FP_FROMINT(-40), angle += 1000);
+}
+
+static void FocInvParkClarke()
+{
+   FOC::InvParkClarke(10000, 15000, angle += 1000);
+}
+
+static void FocSqrt()
+{
+   sink = FocChannel::sqrt(angle++ * 1000U);
+}
+
+static void FocFpSqrt()
+{
+   sink = FocChannel::fpsqrt(angle++ * 1000U);
+}
+
+static void Atan2()
+{
+   angle++;
+   sink = SineCore::Atan2(SineCore::Cosine(angle), SineCore::Sine(angle));
+}
+
+static void Atan2Table()
+{
+   angle++;
+   sink = SineCore::Atan2Table(SineCore::Cosine(angle), SineCore::Sine(angle));
+}
+
+static void PiControllerRun()
+{
+   sink = pi.Run(angle++ & 0x3ff);
+}
+
+static void PiSeparate4()
+{
+   s32fp cur = angle++ & 0x3ff;
+
+   for (int i = 0; i < 4; i++)
+      sink = piSeparate[i].Run(cur + i);
+}
+
+static void Pi64Separate4()
+{
+   s32fp cur = angle++ & 0x3ff;
+
+   for (int i = 0; i < 4; i++)
+      sink = pi64Separate[i].Run(cur + i);
+}
+
+static void PiBank4()
+{
+   s32fp cur = angle++ & 0x3ff;
+   s32fp curVal[4] = { cur, cur + 1, cur + 2, cur + 3 };
+   int32_t y[4];
+
+   piBank.Run(curVal, y);
+   sink = y[3];
+}
+
+static void PidP()
+{
+   sink = pidP.Run(angle++ & 0x3ff);
+}
+
+static void PidPI()
+{
+   sink = pidPI.Run(angle++ & 0x3ff);
+}
+
+static void PidPID()
+{
+   sink = pidPID.Run(angle++ & 0x3ff);
+}
+
+static void PidPIDFF()
+{
+   sink = pidPIDFF.Run(angle++ & 0x3ff);
+}
+
+template <bool I, bool D, bool FF>
+static void SetupPid(PidController<I, D, FF>& pid)
+{
+   pid.SetGains(100, 2000, 10);
+   pid.SetFeedForwardGain(2);
+   pid.SetFeedForward(FP_FROMINT(10));
+   pid.SetDerivativeFilter(2);
+   pid.SetCallingFrequency(8800);
+   pid.SetMinMaxY(-30000, 30000);
+   pid.SetRef(512);
+}
+
+static void ParamGet()
+{
+   sink = Param::Get(Param::boost) + Param::GetInt(Param::canperiod);
+}
+
+static void ParamSet()
+{
+   Param::Set(Param::boost, FP_FROMINT(angle++ & 0x3ff));
+}
+
+static void ParamGetTyped()
+{
+   sink = Param::Get<Param::boost>() + Param::GetInt<Param::canperiod>();
+}
+
+static void ParamSetTyped()
+{
+   Param::Set<Param::boost>(FP_FROMINT(angle++ & 0x3ff));
+}
+
+static void ParamSetUnchanged()
+{
+   Param::Set(Param::boost, FP_FROMINT(1700));
+}
+
+static void ParamNumFromString()
+{
+   sink = Param::NumFromString("pwmfrq");
+}
+
+static void CanSendAll()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   can->SendAll();
+   while (hal_can_host_transmit_complete(CAN1, &id, &len, data));
+}
+
+static void CanHandleRx()
+{
+   uint32_t data[2] = { angle++, 0 };
+
+   hal_can_host_receive(CAN1, 0x200, 8, data);
+   can->HandleRx(0);
+}
+
+static void FpItoa()
+{
+   fp_itoa(buf, angle++ * 1000);
+}
+
+static void Sprintf()
+{
+   sprintf(buf, "%d %f", angle++, FP_FROMINT(12));
+}
+
+static void AnaInGet()
+{
+   sink = AnaIn::throttle1.Get();
+}
+
+int main(int argc, char* argv[])
+{
+   TestBenchmarkInit(argc, argv);
+
+   Param::LoadDefaults();
+   SineCore::SetAmp(30000);
+   pi.SetGains(100, 2000);
+   pi.SetCallingFrequency(8800);
+   pi.SetMinMaxY(-30000, 30000);
+   pi.SetRef(512);
+   piBank.SetCallingFrequency(8800);
+
+   for (int i = 0; i < 4; i++)
+   {
+      piSeparate[i].SetGains(100, 2000);
+      piSeparate[i].SetCallingFrequency(8800);
+      piSeparate[i].SetMinMaxY(-30000, 30000);
+      piSeparate[i].SetRef(512);
+      pi64Separate[i].SetGains(100, 2000);
+      pi64Separate[i].SetCallingFrequency(8800);
+      pi64Separate[i].SetMinMaxY(-30000, 30000);
+      pi64Separate[i].SetRef(512);
+      piBank.SetGains(i, 100, 2000);
+      piBank.SetMinMaxY(i, -30000, 30000);
+      piBank.SetRef(i, 512);
+   }
+   SetupPid(pidP);
+   SetupPid(pidPI);
+   SetupPid(pidPID);
+   SetupPid(pidPIDFF);
+
+   can = new Can(CAN1, Can::Baud500);
+   can->AddSend(Param::boost, 0x100, 0, 16, 32);
+   can->AddSend(Param::fweak, 0x100, 16, 16, 32);
+   can->AddSend(Param::polepairs, 0x100, 32, 8, 32);
+   can->AddSend(Param::curkp, 0x101, 0, 32, 32);
+   can->AddRecv(Param::curki, 0x200, 0, 16, 32);
+
+   ANA_IN_CONFIGURE(ANA_IN_LIST);
+   AnaIn::Start();
+   hal_adc_host_set(11, 1000);
+   hal_adc_host_convert(NUM_SAMPLES);
+
+   BENCHMARK(SineCoreCalc, 1000000);
+   BENCHMARK(FocParkClarke, 1000000);
+   BENCHMARK(FocInvParkClarke, 1000000);
+   BENCHMARK(FocSqrt, 1000000);
+   BENCHMARK(FocFpSqrt, 1000000);
+   BENCHMARK(Atan2, 1000000);
+   BENCHMARK(Atan2Table, 1000000);
+   BENCHMARK(PiControllerRun, 1000000);
+   BENCHMARK(PiSeparate4, 1000000);
+   BENCHMARK(Pi64Separate4, 1000000);
+   BENCHMARK(PiBank4, 1000000);
+   BENCHMARK(PidP, 1000000);
+   BENCHMARK(PidPI, 1000000);
+   BENCHMARK(PidPID, 1000000);
+   BENCHMARK(PidPIDFF, 1000000);
+   BENCHMARK(ParamGet, 1000000);
+   BENCHMARK(ParamSet, 1000000);
+   BENCHMARK(ParamSetUnchanged, 1000000);
+   BENCHMARK(ParamGetTyped, 1000000);
+   BENCHMARK(ParamSetTyped, 1000000);
+   BENCHMARK(ParamNumFromString, 1000000);
+   BENCHMARK(CanSendAll, 200000);
+   BENCHMARK(CanHandleRx, 200000);
+   BENCHMARK(FpItoa, 1000000);
+   BENCHMARK(Sprintf, 200000);
+   BENCHMARK(AnaInGet, 1000000);
+
+   delete can;
+   return TestResult();
+}
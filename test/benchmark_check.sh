@@ -0,0 +1,64 @@
+#!/bin/sh
+# Median of several benchmark runs, compared against a baseline
+#
+# Usage: benchmark_check.sh <benchmark> <runs> <threshold> <baseline> <report>
+#
+# Runs <benchmark> <runs> times as separate processes and writes the median
+# of each entry to <report> in the baseline format. Prints every entry with
+# its change against <baseline> and fails if one got slower by more than
+# <threshold> percent. Copy the report over the baseline to accept it.
+
+benchmark=$1
+runs=$2
+threshold=$3
+baseline=$4
+report=$5
+runfile=$report.runs
+
+: > "$runfile"
+i=0
+while [ $i -lt "$runs" ]
+do
+   "$benchmark" >> "$runfile" || exit 1
+   i=$((i + 1))
+done
+
+[ -f "$baseline" ] || baseline=/dev/null
+
+awk -v baseline="$baseline" -v report="$report" -v threshold="$threshold" '
+FILENAME == baseline { if ($1 == "bench") base[$2] = $3; next }
+$1 == "bench" {
+   if (!($2 in count)) order[++numEntries] = $2
+   times[$2, ++count[$2]] = $3
+}
+END {
+   printf "" > report
+   for (i = 1; i <= numEntries; i++)
+   {
+      name = order[i]
+      n = count[name]
+
+      for (a = 2; a <= n; a++)
+      {
+         t = times[name, a]
+         for (b = a - 1; b >= 1 && times[name, b] > t; b--) times[name, b + 1] = times[name, b]
+         times[name, b + 1] = t
+      }
+      median = n % 2 ? times[name, (n + 1) / 2] : (times[name, n / 2] + times[name, n / 2 + 1]) / 2
+      printf "bench %-32s %10.2f\n", name, median >> report
+
+      if (name in base)
+      {
+         change = 100 * (median - base[name]) / base[name]
+         regression = change > threshold
+         printf "bench %-32s %10.2f baseline %10.2f %+6.1f%%%s\n", name, median, base[name], change, regression ? " REGRESSION" : ""
+         failures += regression
+      }
+      else
+      {
+         printf "bench %-32s %10.2f (no baseline)\n", name, median
+      }
+   }
+   printf "%d entries, median of %d runs, %d slower than %s%%\n", numEntries, n, failures, threshold
+   exit failures > 0
+}' "$baseline" "$runfile"
@@ -0,0 +1,82 @@
+#!/bin/sh
+# Per symbol flash and RAM footprint of the library objects, diffed against a baseline
+#
+# Usage: footprint.sh <nm> <baseline> <report> <object>...
+#
+# Writes one tab separated line "module flash ram symbol" per symbol to
+# <report>, then prints the module totals and every symbol that changed
+# against <baseline>. Flash is text, rodata and initialized data, RAM is
+# initialized data and bss. Copy the report over the baseline to accept it.
+
+nm=$1
+baseline=$2
+report=$3
+shift 3
+
+for obj in "$@"
+do
+   module=$(basename "$obj")
+   module=${module%.o}
+   module=${module%.obj}
+   module=${module%.cpp}
+   module=${module%.c}
+
+   "$nm" -S --size-sort -C "$obj" | awk -v module="$module" '
+   {
+      size = 0
+      hex = toupper($2)
+      for (i = 1; i <= length(hex); i++)
+         size = size * 16 + index("0123456789ABCDEF", substr(hex, i, 1)) - 1
+
+      type = toupper($3)
+      flash = (type == "T" || type == "R" || type == "D") ? size : 0
+      ram = (type == "D" || type == "B") ? size : 0
+      name = $4
+      for (i = 5; i <= NF; i++) name = name " " $i
+
+      if (flash + ram > 0) printf "%s\t%d\t%d\t%s\n", module, flash, ram, name
+   }'
+done | sort > "$report" || exit 1
+
+[ -f "$baseline" ] || baseline=/dev/null
+
+awk -F '\t' -v baseline="$baseline" '
+FILENAME == baseline { key = $1 "\t" $4; baseFlash[key] = $2; baseRam[key] = $3
+            modBaseFlash[$1] += $2; modBaseRam[$1] += $3; next }
+{
+   key = $1 "\t" $4; seen[key] = 1
+   if (!($1 in modFlash)) order[++numModules] = $1
+   modFlash[$1] += $2; modRam[$1] += $3
+   if (!(key in baseFlash))
+      changes[++numChanges] = sprintf("  + %-14s %-50s %6d %6d", $1, $4, $2, $3)
+   else if (baseFlash[key] != $2 || baseRam[key] != $3)
+      changes[++numChanges] = sprintf("  ~ %-14s %-50s %+6d %+6d", $1, $4, $2 - baseFlash[key], $3 - baseRam[key])
+}
+END {
+   for (key in baseFlash)
+   {
+      if (!(key in seen))
+      {
+         split(key, parts, "\t")
+         changes[++numChanges] = sprintf("  - %-14s %-50s %+6d %+6d", parts[1], parts[2], -baseFlash[key], -baseRam[key])
+      }
+   }
+
+   printf "%-18s %8s %8s %8s %8s\n", "module", "flash", "ram", "dflash", "dram"
+   for (m in modBaseFlash)
+      if (!(m in modFlash)) order[++numModules] = m
+
+   for (i = 1; i <= numModules; i++)
+   {
+      m = order[i]
+      printf "%-18s %8d %8d %+8d %+8d\n", m, modFlash[m], modRam[m], modFlash[m] - modBaseFlash[m], modRam[m] - modBaseRam[m]
+      flash += modFlash[m]; ram += modRam[m]; baseFlashTotal += modBaseFlash[m]; baseRamTotal += modBaseRam[m]
+   }
+   printf "%-18s %8d %8d %+8d %+8d\n", "total", flash, ram, flash - baseFlashTotal, ram - baseRamTotal
+
+   if (numChanges > 0)
+   {
+      printf "\nChanged symbols (flash ram):\n"
+      for (i = 1; i <= numChanges; i++) print changes[i]
+   }
+}' "$baseline" "$report"
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include "my_fp.h"
+
+/* fp_atoi() with every string. The first byte selects the number of
+ * fractional digits, the library passes FRAC_DIGITS and 16 */
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+   char str[64];
+
+   if (size < 1) return 0;
+
+   int fracDigits = data[0] & 1 ? 16 : FRAC_DIGITS;
+
+   size = size - 1 < sizeof(str) - 1 ? size - 1 : sizeof(str) - 1;
+   memcpy(str, data + 1, size);
+   str[size] = 0;
+   fp_atoi(str, fracDigits);
+
+   return 0;
+}
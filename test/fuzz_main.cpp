@@ -0,0 +1,221 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+/* Stand-in for libFuzzer where it is not available, e.g. with gcc. Usage:
+ *
+ *    fuzz_target [-runs=N] [-seed=S] [-max_len=L] file|directory...
+ *
+ * Runs every given input through LLVMFuzzerTestOneInput(), then N inputs
+ * created by randomly mutating them. The input that is being run when a
+ * sanitizer aborts is written to crash-input in the current directory, so
+ * it can be replayed with "fuzz_target crash-input". The options use
+ * libFuzzer syntax so the same command line works with both.
+ */
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#define MAX_INPUTS 4096
+
+static uint8_t* inputs[MAX_INPUTS];
+static size_t sizes[MAX_INPUTS];
+static int numInputs = 0;
+static const uint8_t* current;
+static size_t currentSize;
+
+#ifdef __SANITIZE_ADDRESS__
+static void WriteCurrent()
+{
+   FILE* f = fopen("crash-input", "wb");
+
+   if (f != NULL)
+   {
+      fwrite(current, 1, currentSize, f);
+      fclose(f);
+      fputs("Input written to crash-input\n", stderr);
+   }
+}
+#endif
+
+static void Run(const uint8_t* data, size_t size)
+{
+   current = data;
+   currentSize = size;
+   LLVMFuzzerTestOneInput(data, size);
+}
+
+static void Load(const char* path)
+{
+   FILE* f = fopen(path, "rb");
+
+   if (f == NULL || numInputs == MAX_INPUTS)
+   {
+      fprintf(stderr, "Skipping %s\n", path);
+      if (f != NULL) fclose(f);
+      return;
+   }
+
+   long size = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+   uint8_t* data = size >= 0 ? (uint8_t*)malloc(size > 0 ? size : 1) : NULL;
+
+   if (data == NULL || fseek(f, 0, SEEK_SET) != 0)
+   {
+      fprintf(stderr, "Cannot read %s\n", path);
+      free(data);
+      fclose(f);
+      return;
+   }
+
+   sizes[numInputs] = fread(data, 1, size, f);
+   inputs[numInputs++] = data;
+   fclose(f);
+}
+
+static void LoadPath(const char* path)
+{
+   struct stat st;
+
+   if (stat(path, &st) == 0 && S_ISDIR(st.st_mode))
+   {
+      DIR* dir = opendir(path);
+      struct dirent* entry;
+
+      while (dir != NULL && (entry = readdir(dir)) != NULL)
+      {
+         if (entry->d_name[0] == '.') continue;
+
+         char file[1024];
+         snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+         Load(file);
+      }
+
+      if (dir != NULL) closedir(dir);
+   }
+   else
+   {
+      Load(path);
+   }
+}
+
+/** Change a copy of a random input by flipping bits, replacing, inserting or
+ * deleting bytes, or splicing in part of another input */
+static size_t Mutate(uint8_t* out, size_t maxLen)
+{
+   int idx = rand() % numInputs;
+   size_t len = sizes[idx] < maxLen ? sizes[idx] : maxLen;
+   int mutations = 1 + rand() % 4;
+
+   memcpy(out, inputs[idx], len);
+
+   for (int i = 0; i < mutations; i++)
+   {
+      size_t pos = len > 0 ? rand() % len : 0;
+
+      switch (rand() % 6)
+      {
+      case 0: //Flip a bit
+         if (len > 0) out[pos] ^= 1 << (rand() % 8);
+         break;
+      case 1: //Random byte
+         if (len > 0) out[pos] = rand();
+         break;
+      case 2: //Interesting character
+         if (len > 0) out[pos] = " ,-.0123456789\n\r\xff"[rand() % 17];
+         break;
+      case 3: //Insert byte
+         if (len < maxLen)
+         {
+            memmove(out + pos + 1, out + pos, len - pos);
+            out[pos] = rand();
+            len++;
+         }
+         break;
+      case 4: //Delete byte
+         if (len > 0)
+         {
+            memmove(out + pos, out + pos + 1, len - pos - 1);
+            len--;
+         }
+         break;
+      default: //Splice another input
+      {
+         int other = rand() % numInputs;
+         size_t n = sizes[other] < maxLen - pos ? sizes[other] : maxLen - pos;
+         memcpy(out + pos, inputs[other], n);
+         len = pos + n > len ? pos + n : len;
+         break;
+      }
+      }
+   }
+
+   return len;
+}
+
+int main(int argc, char* argv[])
+{
+   long runs = 0;
+   unsigned seed = 1;
+   size_t maxLen = 512;
+
+#ifdef __SANITIZE_ADDRESS__
+   __sanitizer_set_death_callback(WriteCurrent);
+#endif
+
+   for (int i = 1; i < argc; i++)
+   {
+      if (strncmp(argv[i], "-runs=", 6) == 0)
+         runs = atol(argv[i] + 6);
+      else if (strncmp(argv[i], "-seed=", 6) == 0)
+         seed = atol(argv[i] + 6);
+      else if (strncmp(argv[i], "-max_len=", 9) == 0)
+         maxLen = atol(argv[i] + 9);
+      else if (argv[i][0] == '-')
+         fprintf(stderr, "Ignoring option %s\n", argv[i]);
+      else
+         LoadPath(argv[i]);
+   }
+
+   for (int i = 0; i < numInputs; i++)
+      Run(inputs[i], sizes[i]);
+
+   fprintf(stderr, "Ran %d inputs\n", numInputs);
+
+   if (runs > 0 && numInputs > 0 && maxLen > 0)
+   {
+      uint8_t* buf = (uint8_t*)malloc(maxLen);
+
+      srand(seed);
+
+      for (long i = 0; i < runs; i++)
+         Run(buf, Mutate(buf, maxLen));
+
+      fprintf(stderr, "Ran %ld mutated inputs\n", runs);
+      free(buf);
+   }
+
+   return 0;
+}
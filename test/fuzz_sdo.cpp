@@ -0,0 +1,64 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include "params.h"
+#include "stm32_can.h"
+#include "hal_can.h"
+#include "my_math.h"
+
+/* Can::ProcessSDO() through the receive path. Every 8 bytes of input are
+ * one SDO request to node 1. The same data is then received on the id the
+ * request addressed, which exercises CAN maps the requests may have added.
+ * In the end all send maps are transmitted once */
+
+static void Drain()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   while (hal_can_host_transmit_complete(CAN1, &id, &len, data));
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+   static Can* can = new Can(CAN1, Can::Baud500);
+
+   Param::LoadDefaults();
+   can->Clear();
+
+   for (size_t pos = 0; pos < size; pos += 8)
+   {
+      uint32_t frame[2] = { 0, 0 };
+      uint16_t index;
+
+      memcpy(frame, data + pos, MIN(size - pos, 8));
+      memcpy(&index, (uint8_t*)frame + 1, sizeof(index));
+
+      hal_can_host_receive(CAN1, 0x601, 8, frame);
+      can->HandleRx(0);
+      hal_can_host_receive(CAN1, index & 0x7FF, 8, frame);
+      can->HandleRx(0);
+      Drain();
+   }
+
+   can->SendAll();
+   Drain();
+
+   return 0;
+}
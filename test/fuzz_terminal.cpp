@@ -0,0 +1,76 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stddef.h>
+#include "params.h"
+#include "terminal.h"
+#include "terminalcommands.h"
+#include "stm32_can.h"
+#include "hal_uart.h"
+#include "hal_can.h"
+
+/* Terminal::Run() line handling: the input is received through the UART
+ * simulation in as large chunks as the DMA buffer takes and the terminal
+ * is run after each chunk. "stream" is left out of the command table, with
+ * a negative count it repeats until a key is pressed */
+
+static const TERM_CMD commands[] =
+{
+   { "set", TerminalCommands::ParamSet },
+   { "get", TerminalCommands::ParamGet },
+   { "flag", TerminalCommands::ParamFlag },
+   { "json", TerminalCommands::PrintParamsJson },
+   { "can", TerminalCommands::MapCan },
+   { "save", TerminalCommands::SaveParameters },
+   { "load", TerminalCommands::LoadParameters },
+   { "reset", TerminalCommands::Reset },
+   { "history", TerminalCommands::PrintHistory },
+   { NULL, NULL }
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+   static Can* can = new Can(CAN1, Can::Baud500);
+   static Terminal* term = new Terminal(USART3, commands);
+   static char output[256];
+   const char* in = (const char*)data;
+   int stalled = 0;
+
+   Param::LoadDefaults();
+   can->Clear();
+   term->SetNodeId(1);
+
+   while (size > 0 && stalled < 2)
+   {
+      int accepted = hal_uart_host_receive(USART3, in, size);
+
+      in += accepted;
+      size -= accepted;
+      stalled = accepted > 0 ? 0 : stalled + 1;
+      term->Run();
+
+      while (hal_uart_host_transmitted(USART3, output, sizeof(output)) > 0);
+   }
+
+   //Terminate a partial line so the next input starts on a fresh line
+   hal_uart_host_receive(USART3, "\n", 1);
+   term->Run();
+   while (hal_uart_host_transmitted(USART3, output, sizeof(output)) > 0);
+
+   return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <stddef.h>
+#include "params.h"
+#include "terminal.h"
+#include "terminalcommands.h"
+#include "stm32_can.h"
+#include "hal_uart.h"
+#include "hal_can.h"
+#include "my_string.h"
+#include "my_math.h"
+
+/* Every TerminalCommands function with arbitrary arguments. The first byte
+ * selects the function, the rest is the argument string the way Terminal
+ * passes it: at most 127 characters, zero terminated, written in place */
+
+static const TERM_CMD commands[] =
+{
+   { "set", TerminalCommands::ParamSet },
+   { "get", TerminalCommands::ParamGet },
+   { "flag", TerminalCommands::ParamFlag },
+   { "stream", TerminalCommands::ParamStream },
+   { "json", TerminalCommands::PrintParamsJson },
+   { "can", TerminalCommands::MapCan },
+   { "save", TerminalCommands::SaveParameters },
+   { "load", TerminalCommands::LoadParameters },
+   { "reset", TerminalCommands::Reset },
+   { "history", TerminalCommands::PrintHistory },
+};
+
+#define NUM_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+#define ARG_SIZE     128
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+   static Can* can = new Can(CAN1, Can::Baud500);
+   static Terminal* term = new Terminal(USART3, commands);
+   static char output[256];
+   char arg[ARG_SIZE];
+
+   if (size < 1) return 0;
+
+   const TERM_CMD& cmd = commands[data[0] % NUM_COMMANDS];
+
+   size = MIN(size - 1, ARG_SIZE - 1);
+   memcpy(arg, data + 1, size);
+   arg[size] = 0;
+
+   //A stream only ends early on a key press, keep it short
+   if (cmd.CmdFunc == TerminalCommands::ParamStream)
+   {
+      int repetitions = my_atoi(my_trim(arg));
+      if (repetitions < 0 || repetitions > 10) return 0;
+   }
+
+   Param::LoadDefaults();
+   can->Clear();
+   cmd.CmdFunc(term, arg);
+
+   while (hal_uart_host_transmitted(USART3, output, sizeof(output)) > 0);
+
+   return 0;
+}
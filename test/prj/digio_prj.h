@@ -0,0 +1,26 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DIGIO_PRJ_H_INCLUDED
+#define DIGIO_PRJ_H_INCLUDED
+
+#define DIG_IO_LIST \
+    DIG_IO_ENTRY(start_in, GPIOB, GPIO6,  PinMode::INPUT_PD) \
+    DIG_IO_ENTRY(led_out,  GPIOC, GPIO13, PinMode::OUTPUT)
+
+#endif // DIGIO_PRJ_H_INCLUDED
@@ -0,0 +1,28 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef HWDEFS_H_INCLUDED
+#define HWDEFS_H_INCLUDED
+
+/* Memory layout of the simulated 128 kB flash, see hal_flash_host.cpp */
+#define FLASH_PAGE_SIZE 1024
+#define PARAM_BLKSIZE   FLASH_PAGE_SIZE
+#define PARAM_ADDRESS   (0x08000000 + 0x20000 - PARAM_BLKSIZE)
+#define CANMAP_ADDRESS  (PARAM_ADDRESS - FLASH_PAGE_SIZE)
+
+#endif // HWDEFS_H_INCLUDED
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PARAM_PRJ_H_INCLUDED
+#define PARAM_PRJ_H_INCLUDED
+
+/* Parameter list of the host test build. It contains every entry kind so the
+ * tests and fuzz targets reach all code paths of Param and TerminalCommands */
+#define PARAM_HISTORY_SIZE 8
+
+#define PARAM_LIST \
+    PARAM_ENTRY("Motor", boost,     "dig",   0,     37813,  1700,  1 ) \
+    PARAM_ENTRY("Motor", fweak,     "Hz",    0,     400,    67,    2 ) \
+    PARAM_ENTRY("Motor", polepairs, "",      1,     16,     2,     3 ) \
+    PARAM_ENTRY("Control", curkp,   "",      0,     20000,  32,    4 ) \
+    PARAM_ENTRY("Control", curki,   "",      0,     100000, 20000, 5 ) \
+    TYPED_ENTRY("Control", canperiod, "ms",  1,     1000000, 100,  6, INT) \
+    TYPED_ENTRY("Control", pwmfrq,  "",      0,     4,      1,     7, ENUM) \
+    TYPED_ENTRY("Control", dismask, "",      0,     0xFFFFFFFF, 0, 8, BITFIELD) \
+    PARAM_ENTRY("Gains", gsx0,      "Hz",    0,     1000,   10,    9 ) \
+    PARAM_ENTRY("Gains", gsx1,      "Hz",    0,     1000,   100,   10) \
+    PARAM_ENTRY("Gains", gskp0,     "",      0,     10000,  100,   11) \
+    PARAM_ENTRY("Gains", gskp1,     "",      0,     10000,  300,   12) \
+    PARAM_ENTRY("Gains", gski0,     "",      0,     10000,  1000,  13) \
+    PARAM_ENTRY("Gains", gski1,     "",      0,     10000,  2000,  14) \
+    VALUE_ENTRY(opmode,     "",     2000 ) \
+    VALUE_ENTRY(version,    "",     2001 ) \
+    VALUE_ENTRY(pwmcycles,  "",     2002 ) \
+    VALUE_ENTRY(pwmmax,     "",     2003 ) \
+    TYPED_VALUE_ENTRY(uptime, "s",  2004, INT) \
+    TYPED_VALUE_ENTRY(status, "",   2005, BITFIELD)
+
+#endif // PARAM_PRJ_H_INCLUDED
@@ -0,0 +1,27 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PROFILER_PRJ_H_INCLUDED
+#define PROFILER_PRJ_H_INCLUDED
+
+#define PROFILING 1
+
+#define PROFILE_LIST \
+    PROFILE_ENTRY(pwm, Param::pwmcycles, Param::pwmmax)
+
+#endif // PROFILER_PRJ_H_INCLUDED
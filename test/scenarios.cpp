@@ -0,0 +1,428 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include "pmsmmodel.h"
+#include "acimmodel.h"
+#include "foc.h"
+#include "fieldweakening.h"
+#include "fu.h"
+#include "sine_core.h"
+#include "pidcontroller.h"
+#include "test.h"
+
+/* Closed loop scenarios of the control code against PmsmModel and AcimModel.
+ * Each scenario logs the tracking error of its controlled quantity, the
+ * current ripple in steady state and the CPU cost of the control code per
+ * cycle. The CPU cost is measured afterwards by replaying the recorded
+ * controller inputs into a fresh controller, so neither the plant model nor
+ * the clock reads are counted. The run fails when tracking gets worse than
+ * the limits below, CPU cost is reported only.
+ */
+
+#define FREQUENCY  8800
+#define MAX_CYCLES (3 * FREQUENCY)
+#define UDC        FP_FROMINT(300)
+
+/** Controller inputs of one cycle */
+struct Sample
+{
+   s32fp il1;
+   s32fp il2;
+   uint16_t angle;
+   int16_t angleStep; //!< angle change until the next cycle
+   s32fp ref; //!< current in A, speed in rpm or frequency in Hz
+   s32fp speed; //!< measured speed in rpm
+};
+
+struct Report
+{
+   double sumErrPow2;
+   double maxErr;
+   int count;
+   float minRipple;
+   float maxRipple;
+
+   void Track(float err)
+   {
+      sumErrPow2 += err * err;
+      maxErr = fmax(maxErr, fabs(err));
+      count++;
+   }
+
+   void Ripple(float val)
+   {
+      minRipple = minRipple < maxRipple ? fminf(minRipple, val) : val;
+      maxRipple = fmaxf(maxRipple, val);
+   }
+
+   double Rms() { return sqrt(sumErrPow2 / count); }
+   float PeakToPeak() { return maxRipple - minRipple; }
+
+   void Print(const char* name, const char* unit, double nsPerCycle)
+   {
+      TestLog("%-24s %8.2f %8.2f %-4s %7.2f A %9.1f\n", name, Rms(), maxErr, unit, PeakToPeak(), nsPerCycle);
+   }
+};
+
+static Sample samples[MAX_CYCLES];
+static volatile int32_t sink;
+
+/** Time the control code on the samples of the last scenario
+ * \return ns per cycle, best of 5 runs
+ */
+template <class Controller>
+static double CpuCostNs(int cycles)
+{
+   long long best = -1;
+
+   for (int run = 0; run < 5; run++)
+   {
+      Controller controller;
+      long long start = TestCpuTimeNs();
+
+      for (int i = 0; i < cycles; i++)
+         sink = controller.Run(samples[i])[0];
+
+      long long time = TestCpuTimeNs() - start;
+      best = best < 0 ? time : MIN(best, time);
+   }
+
+   return (double)best / cycles;
+}
+
+static float ToFloat(s32fp val)
+{
+   return val / (float)(1 << FRAC_DIGITS);
+}
+
+/** PI current controllers in rotor coordinates */
+struct CurrentControl
+{
+   FocChannel foc;
+   PidController<true, false, false> controllerD, controllerQ;
+   int32_t ud, uq;
+
+   /** \param kp modulation digits per A, \param ki modulation digits per As */
+   CurrentControl(int kp, int ki)
+    : ud(0), uq(0)
+   {
+      controllerD.SetGains(kp, ki, 0);
+      controllerQ.SetGains(kp, ki, 0);
+      controllerD.SetCallingFrequency(FREQUENCY);
+      controllerQ.SetCallingFrequency(FREQUENCY);
+      controllerD.SetMinMaxY(-foc.GetMaximumModulationIndex(), foc.GetMaximumModulationIndex());
+   }
+
+   const int32_t* Run(const Sample& sample, s32fp idref, s32fp iqref)
+   {
+      foc.ParkClarke(sample.il1, sample.il2, sample.angle);
+      controllerD.SetRef(idref);
+      controllerQ.SetRef(iqref);
+      ud = controllerD.Run(foc.id);
+      //q voltage gets what is left of the voltage circle
+      int32_t qLimit = foc.GetQLimit(ud);
+      controllerQ.SetMinMaxY(-qLimit, qLimit);
+      uq = controllerQ.Run(foc.iq);
+      //The voltage is applied until the next cycle, use the mean angle of that time
+      foc.InvParkClarke(ud, uq, sample.angle + sample.angleStep / 2);
+      return foc.DutyCycles;
+   }
+};
+
+/* 20 mOhm, Ld 100 µH, Lq 150 µH, 50 mVs, 4 pole pairs. The current
+ * controllers have about 3000 rad/s bandwidth at 300 V */
+static void SetupPmsm(PmsmModel& motor)
+{
+   motor.SetElectricalParameters(0.02f, 100e-6f, 150e-6f, 0.05f, 4);
+   motor.SetCallingFrequency(FREQUENCY, 4);
+}
+
+static void Record(Sample& sample, PmsmModel& motor)
+{
+   sample.il1 = motor.GetIl1();
+   sample.il2 = motor.GetIl2();
+   sample.angle = motor.GetAngle();
+   sample.angleStep = lroundf(motor.GetFrequency() * 65536 / FREQUENCY);
+   sample.speed = FP_FROMFLT(motor.GetSpeed());
+}
+
+struct PmsmTorqueControl : CurrentControl
+{
+   PmsmTorqueControl() : CurrentControl(66, 13200) { }
+   const int32_t* Run(const Sample& sample) { return CurrentControl::Run(sample, 0, sample.ref); }
+};
+
+/** iq step from 0 to 100 A after 50 ms at 2000 rpm */
+static void PmsmTorqueStep()
+{
+   const int cycles = FREQUENCY / 5;
+   const int step = FREQUENCY / 20;
+   PmsmModel motor;
+   PmsmTorqueControl control;
+   Report report = { };
+
+   SetupPmsm(motor);
+   motor.SetSpeed(2000);
+
+   for (int i = 0; i < cycles; i++)
+   {
+      Sample& sample = samples[i];
+
+      Record(sample, motor);
+      sample.ref = i < step ? 0 : FP_FROMINT(100);
+      motor.Step(control.Run(sample), UDC);
+
+      //Leave out the rise and the d current transient of the step
+      if (i > step + FREQUENCY / 200) report.Track(motor.GetIq() - ToFloat(sample.ref));
+      if (i > cycles / 2) report.Ripple(motor.GetIq());
+   }
+
+   report.Print("PMSM torque step", "A", CpuCostNs<PmsmTorqueControl>(cycles));
+   CHECK(report.Rms() < 1);
+   CHECK(report.maxErr < 3);
+   CHECK(report.PeakToPeak() < 0.5);
+}
+
+struct PmsmSpeedControl : CurrentControl
+{
+   PidController<true, false, false> speedController;
+
+   //Output is iq in 1/32 A, so small gains can be set with integers
+   PmsmSpeedControl() : CurrentControl(66, 13200)
+   {
+      speedController.SetGains(10, 200, 0);
+      speedController.SetCallingFrequency(FREQUENCY);
+      speedController.SetMinMaxY(FP_FROMINT(-150), FP_FROMINT(150));
+   }
+
+   const int32_t* Run(const Sample& sample)
+   {
+      speedController.SetRef(sample.ref);
+      return CurrentControl::Run(sample, 0, speedController.Run(sample.speed));
+   }
+};
+
+/** Ramp 0 to 3000 rpm in 1 s against 2 Nm load, then hold for 0.5 s */
+static void PmsmSpeedRamp()
+{
+   const int cycles = 3 * FREQUENCY / 2;
+   PmsmModel motor;
+   PmsmSpeedControl control;
+   Report report = { };
+
+   SetupPmsm(motor);
+   motor.SetMechanicalParameters(0.005f, 0.001f);
+   motor.SetLoadTorque(2);
+
+   for (int i = 0; i < cycles; i++)
+   {
+      Sample& sample = samples[i];
+
+      Record(sample, motor);
+      sample.ref = FP_FROMINT(MIN(i * 3000 / FREQUENCY, 3000));
+      motor.Step(control.Run(sample), UDC);
+
+      if (i > FREQUENCY / 10) report.Track(motor.GetSpeed() - ToFloat(sample.ref));
+      if (i > cycles - FREQUENCY / 4) report.Ripple(motor.GetIq());
+   }
+
+   report.Print("PMSM speed ramp", "rpm", CpuCostNs<PmsmSpeedControl>(cycles));
+   //Largest error is the roll back when the load hits at standstill
+   CHECK(report.Rms() < 5);
+   CHECK(report.maxErr < 25);
+   CHECK(report.PeakToPeak() < 0.5);
+}
+
+struct PmsmFieldWeakeningControl : CurrentControl
+{
+   FieldWeakening fieldWeakening;
+
+   PmsmFieldWeakeningControl() : CurrentControl(66, 13200), fieldWeakening(foc)
+   {
+      fieldWeakening.SetMaxModulation(35000);
+      fieldWeakening.SetCurrentLimits(150, -120);
+      //Integral only, a proportional term makes the voltage loop chatter
+      fieldWeakening.SetGains(0, 100);
+      fieldWeakening.SetCallingFrequency(FREQUENCY);
+   }
+
+   const int32_t* Run(const Sample& sample)
+   {
+      int32_t idref, iqref;
+
+      fieldWeakening.Run(FP_TOINT(sample.ref), ud, uq, idref, iqref);
+      return CurrentControl::Run(sample, FP_FROMINT(idref), FP_FROMINT(iqref));
+   }
+};
+
+/** 120 A at 4500 rpm from 150 V, the back EMF of 94 V exceeds the 87 V the
+ * inverter can output */
+static void PmsmFieldWeakening()
+{
+   const int cycles = FREQUENCY / 2;
+   PmsmModel motor;
+   PmsmFieldWeakeningControl control;
+   Report report = { };
+
+   SetupPmsm(motor);
+   motor.SetSpeed(4500);
+
+   for (int i = 0; i < cycles; i++)
+   {
+      Sample& sample = samples[i];
+
+      Record(sample, motor);
+      sample.ref = FP_FROMINT(120);
+      motor.Step(control.Run(sample), FP_FROMINT(150));
+
+      //Field weakening current settles within 0.2 s
+      if (i > FREQUENCY / 5)
+      {
+         report.Track(motor.GetId() - ToFloat(control.controllerD.GetRef()));
+         report.Track(motor.GetIq() - ToFloat(control.controllerQ.GetRef()));
+         report.Ripple(motor.GetIq());
+      }
+   }
+
+   report.Print("PMSM field weakening", "A", CpuCostNs<PmsmFieldWeakeningControl>(cycles));
+   CHECK(motor.GetId() < -50);
+   CHECK(motor.GetTorque() > 20);
+   CHECK(report.Rms() < 3);
+   CHECK(report.PeakToPeak() < 1.5);
+}
+
+/* 0.5 Ohm, 0.4 Ohm, Lm 50 mH, 2 mH leakage, 2 pole pairs, 50 Hz rated */
+static void SetupAcim(AcimModel& motor)
+{
+   motor.SetElectricalParameters(0.5f, 0.4f, 0.05f, 0.002f, 0.002f, 2);
+   motor.SetCallingFrequency(FREQUENCY, 4);
+}
+
+struct AcimUfControl
+{
+   SineChannel sine;
+   uint32_t dutyCycles[3];
+
+   AcimUfControl()
+   {
+      MotorVoltage::SetBoost(800);
+      MotorVoltage::SetWeakeningFrq(FP_FROMINT(50));
+      MotorVoltage::SetMaxAmp(SineCore::MAXAMP);
+   }
+
+   const int32_t* Run(const Sample& sample)
+   {
+      sine.SetAmp(MotorVoltage::GetAmp(sample.ref));
+      sine.Calc(sample.angle);
+      //SineChannel puts phase 2 ahead of phase 1, swap so the model turns forward
+      dutyCycles[0] = sine.DutyCycles[0];
+      dutyCycles[1] = sine.DutyCycles[2];
+      dutyCycles[2] = sine.DutyCycles[1];
+      return (const int32_t*)dutyCycles;
+   }
+};
+
+/** U/f ramp 0 to 50 Hz in 2 s against 5 Nm load, then hold for 0.5 s.
+ * Tracking error is the slip speed */
+static void AcimUfRamp()
+{
+   const int cycles = 5 * FREQUENCY / 2;
+   AcimModel motor;
+   AcimUfControl control;
+   Report report = { };
+   uint32_t angle = 0;
+
+   SetupAcim(motor);
+   motor.SetMechanicalParameters(0.05f, 0.005f);
+   motor.SetLoadTorque(5);
+
+   for (int i = 0; i < cycles; i++)
+   {
+      Sample& sample = samples[i];
+      s32fp frequency = MIN(FP_FROMINT(25) * i / FREQUENCY, FP_FROMINT(50));
+
+      sample.ref = frequency;
+      sample.angle = angle >> 16;
+      //2^32 is one turn, frequency already has FRAC_DIGITS fractional bits
+      angle += ((int64_t)frequency << (32 - FRAC_DIGITS)) / FREQUENCY;
+      motor.Step(control.Run(sample), UDC);
+
+      float currentMagnitude = sqrtf(motor.GetId() * motor.GetId() + motor.GetIq() * motor.GetIq());
+
+      if (i > FREQUENCY / 2) report.Track(ToFloat(frequency) * 30 - motor.GetSpeed());
+      if (i > cycles - FREQUENCY / 4) report.Ripple(currentMagnitude);
+   }
+
+   report.Print("ACIM U/f ramp", "rpm", CpuCostNs<AcimUfControl>(cycles));
+   CHECK(report.maxErr < 60);
+   CHECK(report.PeakToPeak() < 1);
+}
+
+struct AcimTorqueControl : CurrentControl
+{
+   AcimTorqueControl() : CurrentControl(850, 190000) { }
+   const int32_t* Run(const Sample& sample) { return CurrentControl::Run(sample, FP_FROMINT(10), sample.ref); }
+};
+
+/** FOC on the ideal rotor flux angle, magnetize with 10 A for 0.3 s, then
+ * step iq from 0 to 30 A at 1000 rpm */
+static void AcimTorqueStep()
+{
+   const int cycles = FREQUENCY / 2;
+   const int step = 3 * FREQUENCY / 10;
+   AcimModel motor;
+   AcimTorqueControl control;
+   Report report = { };
+   uint16_t lastAngle = 0;
+
+   SetupAcim(motor);
+   motor.SetSpeed(1000);
+
+   for (int i = 0; i < cycles; i++)
+   {
+      Sample& sample = samples[i];
+
+      sample.il1 = motor.GetIl1();
+      sample.il2 = motor.GetIl2();
+      sample.angle = motor.GetFluxAngle();
+      sample.angleStep = sample.angle - lastAngle;
+      sample.ref = i < step ? 0 : FP_FROMINT(30);
+      lastAngle = sample.angle;
+      motor.Step(control.Run(sample), UDC);
+
+      if (i > step + FREQUENCY / 200) report.Track(motor.GetIq() - ToFloat(sample.ref));
+      if (i > cycles - FREQUENCY / 10) report.Ripple(motor.GetIq());
+   }
+
+   report.Print("ACIM torque step", "A", CpuCostNs<AcimTorqueControl>(cycles));
+   CHECK(report.Rms() < 0.5);
+   CHECK(report.maxErr < 4);
+   CHECK(report.PeakToPeak() < 0.5);
+}
+
+int main()
+{
+   TestLog("scenario                 rms err  max err      ripple p-p  ns/cycle\n");
+   RUN_TEST(PmsmTorqueStep);
+   RUN_TEST(PmsmSpeedRamp);
+   RUN_TEST(PmsmFieldWeakening);
+   RUN_TEST(AcimUfRamp);
+   RUN_TEST(AcimTorqueStep);
+   return TestResult();
+}
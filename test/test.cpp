@@ -0,0 +1,175 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include "test.h"
+
+#define BENCH_MAX       64
+#define BENCH_RUNS      10
+#define BENCH_NAME_LEN  64
+
+struct Baseline
+{
+   char name[BENCH_NAME_LEN];
+   double ns;
+};
+
+static int failures = 0;
+static int checks = 0;
+static int tests = 0;
+static Baseline baseline[BENCH_MAX];
+static int baselineCount = 0;
+
+bool TestCheck(bool ok, const char* expr, const char* file, int line)
+{
+   checks++;
+
+   if (!ok)
+   {
+      failures++;
+      printf("%s:%d: check failed: %s\n", file, line, expr);
+   }
+   return ok;
+}
+
+bool TestCheckEqual(long long expected, long long actual, const char* expr, const char* file, int line)
+{
+   checks++;
+
+   if (expected != actual)
+   {
+      failures++;
+      printf("%s:%d: %s is %lld, expected %lld\n", file, line, expr, actual, expected);
+      return false;
+   }
+   return true;
+}
+
+bool TestCheckNear(double expected, double actual, double tolerance, const char* expr, const char* file, int line)
+{
+   checks++;
+
+   if (!(actual >= expected - tolerance && actual <= expected + tolerance))
+   {
+      failures++;
+      printf("%s:%d: %s is %g, expected %g +/- %g\n", file, line, expr, actual, expected, tolerance);
+      return false;
+   }
+   return true;
+}
+
+void TestRun(void (*function)(), const char* name)
+{
+   int before = failures;
+
+   tests++;
+   function();
+   printf("%-40s %s\n", name, failures == before ? "ok" : "FAILED");
+}
+
+void TestLog(const char* format, ...)
+{
+   va_list args;
+
+   va_start(args, format);
+   vprintf(format, args);
+   va_end(args);
+}
+
+int TestResult()
+{
+   printf("%d tests, %d checks, %d failures\n", tests, checks, failures);
+   fflush(stdout);
+   return failures > 0 ? 1 : 0;
+}
+
+long long TestCpuTimeNs()
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+   return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+double TestTimeNs(void (*function)(), int iterations)
+{
+   long long start = TestCpuTimeNs();
+
+   for (int i = 0; i < iterations; i++)
+      function();
+
+   return (double)(TestCpuTimeNs() - start) / iterations;
+}
+
+void TestBenchmarkInit(int argc, char* argv[])
+{
+   char line[128];
+   FILE* file;
+
+   if (argc < 2) return;
+
+   file = fopen(argv[1], "r");
+
+   if (file == 0)
+   {
+      printf("Cannot open baseline %s\n", argv[1]);
+      failures++;
+      return;
+   }
+
+   //Same format as the output, so a run redirected to a file is a new baseline
+   while (baselineCount < BENCH_MAX && fgets(line, sizeof(line), file))
+   {
+      Baseline& entry = baseline[baselineCount];
+
+      if (sscanf(line, "bench %63s %lf", entry.name, &entry.ns) == 2)
+         baselineCount++;
+   }
+   fclose(file);
+}
+
+void TestBenchmark(void (*function)(), const char* name, int iterations)
+{
+   double best = TestTimeNs(function, iterations);
+
+   tests++;
+
+   for (int i = 1; i < BENCH_RUNS; i++)
+   {
+      double ns = TestTimeNs(function, iterations);
+      if (ns < best) best = ns;
+   }
+
+   printf("bench %-32s %10.2f", name, best);
+
+   for (int i = 0; i < baselineCount; i++)
+   {
+      if (strcmp(baseline[i].name, name) == 0)
+      {
+         //Informational, a single run is too noisy to fail on, see benchmark_check.sh
+         printf(" baseline %10.2f %+6.1f%%", baseline[i].ns, 100 * (best - baseline[i].ns) / baseline[i].ns);
+         break;
+      }
+   }
+   //Not printf("\n"), the compiler turns it into putchar() which libopeninv overrides
+   fputs("\n", stdout);
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEST_H_INCLUDED
+#define TEST_H_INCLUDED
+
+/** @brief Minimal support for the host tests, simulations and benchmarks
+ *
+ * A test executable runs its test functions with RUN_TEST() from main() and
+ * returns TestResult(). Output is formatted in test.cpp, so test files may
+ * include printf.h which clashes with <stdio.h>.
+ */
+
+#define CHECK(cond) TestCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQUAL(expected, actual) \
+   TestCheckEqual((long long)(expected), (long long)(actual), #actual, __FILE__, __LINE__)
+#define CHECK_NEAR(expected, actual, tolerance) \
+   TestCheckNear((expected), (actual), (tolerance), #actual, __FILE__, __LINE__)
+#define RUN_TEST(function) TestRun(function, #function)
+#define BENCHMARK(function, iterations) TestBenchmark(function, #function, iterations)
+
+bool TestCheck(bool ok, const char* expr, const char* file, int line);
+bool TestCheckEqual(long long expected, long long actual, const char* expr, const char* file, int line);
+bool TestCheckNear(double expected, double actual, double tolerance, const char* expr, const char* file, int line);
+void TestRun(void (*function)(), const char* name);
+/** printf style output to stdout */
+void TestLog(const char* format, ...) __attribute__((format(printf, 1, 2)));
+/** @return 0 if all checks passed, 1 otherwise */
+int TestResult();
+/** @return process CPU time in nanoseconds */
+long long TestCpuTimeNs();
+/** Run function a number of times and return the CPU time per call in ns */
+double TestTimeNs(void (*function)(), int iterations);
+/** Load the baseline for BENCHMARK() from the command line: [baseline file] */
+void TestBenchmarkInit(int argc, char* argv[]);
+/** Time function (best of several runs), print "bench name ns" and the
+ * change against its baseline, if any */
+void TestBenchmark(void (*function)(), const char* name, int iterations);
+
+#endif // TEST_H_INCLUDED
@@ -0,0 +1,183 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "anglepll.h"
+#include "my_math.h"
+#include "test.h"
+
+/* Update() rate, Extrapolate() is called 3 times in between */
+#define SAMPLE_FREQUENCY 2200
+#define AMPLITUDE 2000
+
+/** Synthetic resolver with angle in radians */
+struct Resolver
+{
+   double angle;
+   int noise;
+
+   void Step(double frequency) { angle += 2 * M_PI * frequency / SAMPLE_FREQUENCY; }
+   int32_t Sin() { return lround(AMPLITUDE * sin(angle)) + Noise(); }
+   int32_t Cos() { return lround(AMPLITUDE * cos(angle)) + Noise(); }
+   int Noise() { return noise > 0 ? rand() % (2 * noise + 1) - noise : 0; }
+
+   /** Error of an estimate in digits, 65536 digits = 360° */
+   int Error(uint16_t estimate, double ahead = 0)
+   {
+      int truth = lround((angle + ahead) / (2 * M_PI) * 65536) & 0xFFFF;
+      return abs((int16_t)(estimate - truth));
+   }
+};
+
+static void Setup(AnglePll& pll)
+{
+   pll.SetGains(34000, 850);
+   pll.SetExtrapolationShift(2);
+}
+
+static void LocksOnNoisySignal()
+{
+   AnglePll pll;
+   Resolver res = { 0, 20 };
+   int maxErr = 0;
+
+   Setup(pll);
+   srand(1);
+
+   for (int i = 0; i < 2 * SAMPLE_FREQUENCY; i++)
+   {
+      res.Step(50);
+      pll.Update(res.Sin(), res.Cos());
+      if (i > 500) maxErr = MAX(maxErr, res.Error(pll.GetAngle()));
+   }
+
+   //1% noise causes 0.4° jitter
+   CHECK(maxErr < 100);
+   CHECK_NEAR(FP_FROMFLT(50), pll.GetFrequency(SAMPLE_FREQUENCY), FP_FROMFLT(0.5));
+}
+
+static void PullsInFromStandstill()
+{
+   const double frequencies[] = { -150, -50, 50, 150 };
+
+   for (double frequency: frequencies)
+   {
+      AnglePll pll;
+      Resolver res = { 0, 0 };
+      int maxErr = 0;
+
+      Setup(pll);
+
+      for (int i = 0; i < 2 * SAMPLE_FREQUENCY; i++)
+      {
+         res.Step(frequency);
+         pll.Update(res.Sin(), res.Cos());
+         if (i > 1000) maxErr = MAX(maxErr, res.Error(pll.GetAngle()));
+      }
+
+      if (!CHECK(maxErr < 50)) TestLog("at %d Hz\n", (int)frequency);
+   }
+}
+
+static void TracksSpeedReversal()
+{
+   //0 -> 300 -> -300 -> 0 Hz, each ramp takes 2 s
+   const double profile[] = { 0, 300, -300, 0 };
+   const int rampLength = 2 * SAMPLE_FREQUENCY;
+   AnglePll pll;
+   Resolver res = { 0, 0 };
+   int maxErr = 0;
+   double maxFrequencyErr = 0;
+
+   Setup(pll);
+
+   for (int i = 0; i < 3 * rampLength; i++)
+   {
+      int ramp = i / rampLength;
+      double frequency = profile[ramp] + (profile[ramp + 1] - profile[ramp]) * (i % rampLength) / rampLength;
+      double step = 2 * M_PI * frequency / SAMPLE_FREQUENCY;
+
+      res.Step(frequency);
+      pll.Update(res.Sin(), res.Cos());
+      maxErr = MAX(maxErr, res.Error(pll.GetAngle()));
+
+      for (int j = 1; j < 4; j++)
+         maxErr = MAX(maxErr, res.Error(pll.Extrapolate(), step * j / 4));
+
+      if (i > 100)
+         maxFrequencyErr = MAX(maxFrequencyErr, fabs((double)pll.GetFrequency(SAMPLE_FREQUENCY) / FRAC_FAC - frequency));
+   }
+
+   //Constant acceleration leaves a lag of about 9° at 300 Hz/s
+   CHECK(maxErr < 2000);
+   CHECK(maxFrequencyErr < 2);
+}
+
+static void ExtrapolatesBetweenSamples()
+{
+   AnglePll pll;
+   Resolver res = { 0, 0 };
+   const double step = 2 * M_PI * 100 / SAMPLE_FREQUENCY;
+   int maxErr = 0;
+
+   Setup(pll);
+
+   for (int i = 0; i < SAMPLE_FREQUENCY; i++)
+   {
+      res.Step(100);
+      pll.Update(res.Sin(), res.Cos());
+
+      for (int j = 1; j < 4; j++)
+      {
+         uint16_t angle = pll.Extrapolate();
+         if (i > 500) maxErr = MAX(maxErr, res.Error(angle, step * j / 4));
+      }
+   }
+
+   CHECK(maxErr < 50);
+}
+
+static void RecoversFromOppositeAngle()
+{
+   AnglePll pll;
+   Resolver res = { 0, 0 };
+   int maxErr = 0;
+
+   Setup(pll);
+   pll.Reset(32768);
+
+   for (int i = 0; i < SAMPLE_FREQUENCY; i++)
+   {
+      res.Step(10);
+      pll.Update(res.Sin(), res.Cos());
+      if (i > 300) maxErr = MAX(maxErr, res.Error(pll.GetAngle()));
+   }
+
+   CHECK(maxErr < 50);
+}
+
+int main()
+{
+   RUN_TEST(LocksOnNoisySignal);
+   RUN_TEST(PullsInFromStandstill);
+   RUN_TEST(TracksSpeedReversal);
+   RUN_TEST(ExtrapolatesBetweenSamples);
+   RUN_TEST(RecoversFromOppositeAngle);
+   return TestResult();
+}
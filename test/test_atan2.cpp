@@ -0,0 +1,124 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include "sine_core.h"
+#include "test.h"
+
+/* Exhaustive input range, covers 11 bit resolver and sin/cos signals */
+#define RANGE 1024
+
+/** Exact angle in digits, 65536 digits = 360° */
+static double ExactAngle(double x, double y)
+{
+   return atan2(y, x) * 32768 / M_PI;
+}
+
+/** Absolute error of an angle in digits */
+static double AngleError(uint16_t angle, double exact)
+{
+   double err = angle - exact;
+
+   if (err > 32768) err -= 65536;
+   if (err < -32768) err += 65536;
+   return fabs(err);
+}
+
+struct ErrorMap
+{
+   //Rows by vector magnitude: <16, <64, <256, <1024 and above
+   double maxErr[5];
+   double sumErr[5];
+   int count[5];
+
+   void Add(int32_t x, int32_t y, uint16_t angle, double exact)
+   {
+      int32_t magPow2 = x * x + y * y;
+      int row = magPow2 < 16 * 16 ? 0 : magPow2 < 64 * 64 ? 1 : magPow2 < 256 * 256 ? 2 : magPow2 < 1024 * 1024 ? 3 : 4;
+      double err = AngleError(angle, exact);
+
+      maxErr[row] = fmax(maxErr[row], err);
+      sumErr[row] += err;
+      count[row]++;
+   }
+
+   double Max() { return fmax(fmax(fmax(maxErr[0], maxErr[1]), fmax(maxErr[2], maxErr[3])), maxErr[4]); }
+
+   void Print()
+   {
+      for (int row = 0; row < 5; row++)
+         TestLog(" %6.2f/%5.2f", maxErr[row], sumErr[row] / count[row]);
+
+      TestLog("\n");
+   }
+};
+
+static void ExhaustiveErrorMap()
+{
+   ErrorMap atan2 = { }, table = { };
+
+   for (int32_t x = -RANGE; x < RANGE; x++)
+   {
+      for (int32_t y = -RANGE; y < RANGE; y++)
+      {
+         if (x == 0 && y == 0) continue;
+
+         double exact = ExactAngle(x, y);
+
+         atan2.Add(x, y, SineCore::Atan2(x, y), exact);
+         table.Add(x, y, SineCore::Atan2Table(x, y), exact);
+      }
+   }
+
+   TestLog("max/mean error in digits by magnitude   <16          <64         <256        <1024       >=1024\n");
+   TestLog("Atan2     ");
+   atan2.Print();
+   TestLog("Table     ");
+   table.Print();
+
+   CHECK(atan2.Max() < 2);
+   CHECK(table.Max() < 1);
+}
+
+static void TableLargeMagnitude()
+{
+   double maxErr = 0;
+
+   //Full 32 bit range including INT32_MIN must neither overflow nor lose precision
+   for (int i = 0; i < 65536; i++)
+   {
+      double phi = i * 2 * M_PI / 65536;
+      int32_t x = lround(cos(phi) * 2147483000.0);
+      int32_t y = lround(sin(phi) * 2147483000.0);
+
+      maxErr = fmax(maxErr, AngleError(SineCore::Atan2Table(x, y), ExactAngle(x, y)));
+   }
+
+   CHECK(maxErr < 1);
+   CHECK_EQUAL(32768, SineCore::Atan2Table(INT32_MIN, 0));
+   CHECK_EQUAL(49152, SineCore::Atan2Table(0, INT32_MIN));
+   CHECK_EQUAL(40960, SineCore::Atan2Table(INT32_MIN, INT32_MIN));
+   CHECK_EQUAL(0, SineCore::Atan2Table(0, 0));
+}
+
+int main()
+{
+   RUN_TEST(ExhaustiveErrorMap);
+   RUN_TEST(TableLargeMagnitude);
+   return TestResult();
+}
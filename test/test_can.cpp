@@ -0,0 +1,181 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "params.h"
+#include "stm32_can.h"
+#include "hal_can.h"
+#include "test.h"
+
+#define SDO_READ        0x22
+#define SDO_READ_REPLY  0x43
+#define SDO_WRITE       0x40
+#define SDO_WRITE_REPLY 0x23
+
+static Can* can;
+
+static void SdoRequest(uint8_t cmd, uint16_t index, uint8_t subIndex, uint32_t value)
+{
+   uint32_t data[2] = { cmd | ((uint32_t)index << 8) | ((uint32_t)subIndex << 24), value };
+
+   CHECK(hal_can_host_receive(CAN1, 0x601, 8, data));
+   can->HandleRx(0);
+}
+
+static void SendMappedValue()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   Param::LoadDefaults();
+   //Gains up to 32 multiply the fixed point value, so 1 sends the integer part
+   CHECK(can->AddSend(Param::boost, 0x100, 8, 16, 1) >= 0);
+   can->SendAll();
+
+   CHECK(hal_can_host_transmit_complete(CAN1, &id, &len, data));
+   CHECK_EQUAL(0x100, id);
+   CHECK_EQUAL(8, len);
+   CHECK_EQUAL(1700, (data[0] >> 8) & 0xffff);
+   CHECK(!hal_can_host_transmit_complete(CAN1, &id, &len, data));
+}
+
+static void ReceiveMappedValue()
+{
+   uint32_t data[2] = { 0x55 << 16, 0 };
+
+   CHECK(can->AddRecv(Param::fweak, 0x200, 16, 8, 32) >= 0);
+   CHECK(hal_can_host_receive(CAN1, 0x200, 8, data));
+   can->HandleRx(0);
+   CHECK_EQUAL(0x55, Param::GetInt(Param::fweak));
+   //Neither mapped nor registered nor SDO, the filters must drop it
+   CHECK(!hal_can_host_receive(CAN1, 0x201, 8, data));
+}
+
+static void SdoRead()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   SdoRequest(SDO_READ, 0x2000, Param::polepairs, 0);
+   CHECK(hal_can_host_transmit_complete(CAN1, &id, &len, data));
+   CHECK_EQUAL(0x581, id);
+   CHECK_EQUAL(SDO_READ_REPLY, data[0] & 0xff);
+   CHECK_EQUAL(FP_FROMINT(2), data[1]);
+}
+
+static void SdoIntegerKindsUseFullRange()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   SdoRequest(SDO_WRITE, 0x2000, Param::canperiod, 999999);
+   CHECK(hal_can_host_transmit_complete(CAN1, &id, &len, data));
+   CHECK_EQUAL(SDO_WRITE_REPLY, data[0] & 0xff);
+   CHECK_EQUAL(999999, Param::GetInt(Param::canperiod));
+
+   //Beyond 2^26, where Param::Get() saturates
+   Param::SetInt(Param::uptime, 100000000);
+   SdoRequest(SDO_READ, 0x2000, Param::uptime, 0);
+   CHECK(hal_can_host_transmit_complete(CAN1, &id, &len, data));
+   CHECK_EQUAL(SDO_READ_REPLY, data[0] & 0xff);
+   CHECK_EQUAL(100000000, data[1]);
+}
+
+static void SendMappedIntegerValue()
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   Param::SetInt(Param::uptime, 100000000);
+   CHECK(can->AddSend(Param::uptime, 0x120, 0, 32, 1) >= 0);
+   can->SendAll();
+
+   while (hal_can_host_transmit_complete(CAN1, &id, &len, data) && id != 0x120);
+   CHECK_EQUAL(0x120, id);
+   CHECK_EQUAL(100000000, data[0]);
+   while (hal_can_host_transmit_complete(CAN1, &id, &len, data));
+}
+
+static void ReceiveMappedIntegerValue()
+{
+   uint32_t data[2] = { 0xDEADBEEF, 0 };
+
+   //All 32 bits of a bitfield, through Param::Set() only 26 would survive
+   CHECK(can->AddRecv(Param::dismask, 0x210, 0, 32, 32) >= 0);
+   CHECK(hal_can_host_receive(CAN1, 0x210, 8, data));
+   can->HandleRx(0);
+   CHECK_EQUAL(0xDEADBEEF, (uint32_t)Param::GetInt(Param::dismask));
+   CHECK(can->Remove(Param::dismask) > 0);
+}
+
+static void MapSurvivesSaveAndLoad()
+{
+   int canId, offset, length;
+   s32fp gain;
+   bool rx;
+
+   can->Save();
+   delete can;
+   can = new Can(CAN1, Can::Baud500);
+
+   CHECK(can->FindMap(Param::boost, canId, offset, length, gain, rx));
+   CHECK_EQUAL(0x100, canId);
+   CHECK_EQUAL(8, offset);
+   CHECK_EQUAL(16, length);
+   CHECK(!rx);
+   CHECK(can->FindMap(Param::fweak, canId, offset, length, gain, rx));
+   CHECK_EQUAL(0x200, canId);
+   CHECK(rx);
+}
+
+static void TxQueueDrainsFromInterrupt()
+{
+   uint32_t id, data[2] = { 1, 2 };
+   uint8_t len;
+
+   //Three mailboxes, everything beyond goes to the software queue
+   for (uint32_t i = 0; i < 5; i++)
+      can->Send(0x300 + i, data);
+
+   CHECK_EQUAL(3, hal_can_host_pending(CAN1));
+   CHECK(hal_can_host_tx_irq_enabled(CAN1));
+
+   for (int i = 0; i < 3; i++)
+      CHECK(hal_can_host_transmit_complete(CAN1, &id, &len, data));
+
+   can->HandleTx();
+   CHECK_EQUAL(2, hal_can_host_pending(CAN1));
+   CHECK(!hal_can_host_tx_irq_enabled(CAN1));
+   while (hal_can_host_transmit_complete(CAN1, &id, &len, data));
+}
+
+int main()
+{
+   can = new Can(CAN1, Can::Baud500);
+
+   RUN_TEST(SendMappedValue);
+   RUN_TEST(ReceiveMappedValue);
+   RUN_TEST(SdoRead);
+   RUN_TEST(SdoIntegerKindsUseFullRange);
+   RUN_TEST(SendMappedIntegerValue);
+   RUN_TEST(ReceiveMappedIntegerValue);
+   RUN_TEST(MapSurvivesSaveAndLoad);
+   RUN_TEST(TxQueueDrainsFromInterrupt);
+
+   delete can;
+   return TestResult();
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "errormessage.h"
+#include "stm32_can.h"
+#include "hal_can.h"
+#include "test.h"
+
+static Can* can;
+
+static bool ReceiveEmcy(uint16_t& code, uint8_t& errorRegister, uint8_t& errorNum, uint32_t& time)
+{
+   uint32_t id, data[2];
+   uint8_t len;
+
+   if (!hal_can_host_transmit_complete(CAN1, &id, &len, data)) return false;
+
+   CHECK_EQUAL(0x81, id);
+   code = data[0] & 0xFFFF;
+   errorRegister = (data[0] >> 16) & 0xFF;
+   errorNum = data[0] >> 24;
+   time = data[1] >> 8;
+   return true;
+}
+
+static void EmcyUsesCiA301Codes()
+{
+   uint16_t code;
+   uint8_t errorRegister, errorNum;
+   uint32_t time;
+
+   ErrorMessage::SetTime(1);
+   ErrorMessage::Post(ERR_OVERCURRENT);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   CHECK_EQUAL(0x2310, code);
+   CHECK_EQUAL(0x03, errorRegister); //generic + current
+   CHECK_EQUAL(ERR_OVERCURRENT, errorNum);
+   CHECK_EQUAL(1, time);
+
+   //No code given in the list, falls back to generic error
+   ErrorMessage::Post(ERR_THROTTLE1);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   CHECK_EQUAL(0x1000, code);
+   CHECK_EQUAL(0x01, errorRegister);
+   CHECK_EQUAL(ERR_THROTTLE1, errorNum);
+}
+
+static void HeldBackPostIsSentAfterInterval()
+{
+   uint16_t code;
+   uint8_t errorRegister, errorNum;
+   uint32_t time;
+
+   ErrorMessage::UnpostAll();
+   ErrorMessage::SetTime(5);
+   ErrorMessage::Post(ERR_OVERCURRENT);
+   ErrorMessage::UnpostAll();
+   ErrorMessage::SetTime(6);
+   ErrorMessage::Post(ERR_OVERCURRENT);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+
+   ErrorMessage::SetTime(10);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+
+   //Both posts are merged into one frame carrying the time of the first
+   ErrorMessage::SetTime(11);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   CHECK_EQUAL(ERR_OVERCURRENT, errorNum);
+   CHECK_EQUAL(5, time);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+
+   ErrorMessage::SetTime(30);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+}
+
+static void RateLimitHoldsAcrossTimeWrap()
+{
+   uint16_t code;
+   uint8_t errorRegister, errorNum;
+   uint32_t time;
+
+   ErrorMessage::UnpostAll();
+   ErrorMessage::SetTime(0xFFFFFFF6);
+   ErrorMessage::Post(ERR_THROTTLE1);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   ErrorMessage::UnpostAll();
+   ErrorMessage::SetTime(0xFFFFFFF8);
+   ErrorMessage::Post(ERR_THROTTLE1);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+
+   //Held back frame goes out at time 0, that must not count as never sent
+   ErrorMessage::SetTime(0);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   ErrorMessage::UnpostAll();
+   ErrorMessage::SetTime(1);
+   ErrorMessage::Post(ERR_THROTTLE1);
+   CHECK(!ReceiveEmcy(code, errorRegister, errorNum, time));
+
+   ErrorMessage::SetTime(10);
+   CHECK(ReceiveEmcy(code, errorRegister, errorNum, time));
+   CHECK_EQUAL(ERR_THROTTLE1, errorNum);
+   CHECK_EQUAL(1, time);
+}
+
+int main()
+{
+   can = new Can(CAN1, Can::Baud500);
+   ErrorMessage::SetCanInterface(can, 10);
+
+   RUN_TEST(EmcyUsesCiA301Codes);
+   RUN_TEST(HeldBackPostIsSentAfterInterval);
+   RUN_TEST(RateLimitHoldsAcrossTimeWrap);
+
+   delete can;
+   return TestResult();
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fieldweakening.h"
+#include "test.h"
+
+static void Setup(FocChannel& foc, FieldWeakening& fw, bool mtpa)
+{
+   //50 mVs flux linkage, Lq - Ld = 300 µH
+   foc.SetMotorConstants(1638, 10);
+   fw.SetMaxModulation(30000);
+   fw.SetCurrentLimits(300, -250);
+   fw.SetGains(1, 400);
+   fw.SetCallingFrequency(8800);
+   fw.SetMtpa(mtpa);
+}
+
+static void PassesCurrentWithoutMtpaOrLimit()
+{
+   FocChannel foc;
+   FieldWeakening fw(foc);
+   int32_t idref, iqref;
+
+   Setup(foc, fw, false);
+
+   for (int32_t is = -300; is <= 300; is++)
+   {
+      fw.Run(is, 0, 0, idref, iqref);
+      CHECK_EQUAL(0, idref);
+      CHECK_EQUAL(is, iqref);
+   }
+}
+
+static void MatchesMtpaBelowVoltageLimit()
+{
+   FocChannel foc;
+   FieldWeakening fw(foc);
+   int32_t idref, iqref, idMtpa, iqMtpa;
+
+   Setup(foc, fw, true);
+
+   for (int32_t is = -300; is <= 300; is++)
+   {
+      fw.Run(is, 0, 0, idref, iqref);
+      foc.Mtpa(is, idMtpa, iqMtpa);
+      CHECK_EQUAL(idMtpa, idref);
+      CHECK_EQUAL(iqMtpa, iqref);
+   }
+}
+
+static void StaysInsideCurrentCircle()
+{
+   FocChannel foc;
+   FieldWeakening fw(foc);
+   int32_t idref = 0, iqref = 0;
+
+   Setup(foc, fw, true);
+
+   //Voltage above the limit winds the controller down to minId
+   for (int i = 0; i < 8800; i++)
+   {
+      fw.Run(300, 32000, 10000, idref, iqref);
+      //sqrt() may round up by one
+      CHECK(idref * idref + (iqref - 1) * (iqref - 1) <= 300 * 300);
+   }
+
+   CHECK_EQUAL(-250, idref);
+   CHECK_NEAR(166, iqref, 1);
+   fw.Run(-300, 32000, 10000, idref, iqref);
+   CHECK_NEAR(-166, iqref, 1);
+}
+
+int main()
+{
+   RUN_TEST(PassesCurrentWithoutMtpaOrLimit);
+   RUN_TEST(MatchesMtpaBelowVoltageLimit);
+   RUN_TEST(StaysInsideCurrentCircle);
+   return TestResult();
+}
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "fluxobserver.h"
+#include "pmsmmodel.h"
+#include "foc.h"
+#include "pidcontroller.h"
+#include "test.h"
+
+#define FREQUENCY 8800
+#define POLE_PAIRS 4
+
+struct Result
+{
+   float maxAngleErr; //!< degree
+   float meanAngleErr;
+   float maxIqErr; //!< A
+};
+
+/** Run current control at 50 A iq on a motor held at constant speed.
+ * The first 0.1 s use the true angle so the observer settles, after that
+ * FOC runs on the estimated angle. Errors are taken over the last 0.5 s.
+ * \param frequency electrical frequency in Hz
+ * \param rs actual motor resistance, the observer assumes 20 mOhm
+ */
+static Result Simulate(int frequency, float rs)
+{
+   PmsmModel motor;
+   FocChannel foc;
+   FluxObserver observer;
+   PidController<true, false, false> controllerD, controllerQ;
+   s32fp udc = FP_FROMINT(300);
+   int32_t ud = 0, uq = 0;
+   uint16_t lastAngle = 0;
+   int maxErr = 0, sumErr = 0, samples = 0;
+   float maxIqErr = 0;
+
+   motor.SetElectricalParameters(rs, 100e-6f, 100e-6f, 0.05f, POLE_PAIRS);
+   motor.SetCallingFrequency(FREQUENCY, 4);
+   motor.SetSpeed(frequency * 60.0f / POLE_PAIRS);
+   observer.SetMotorParameters(20, 100, 50000);
+   observer.SetCallingFrequency(FREQUENCY);
+   observer.SetConvergenceRate(300);
+   observer.SetPllGains(24000, 400);
+   observer.Reset(motor.GetAngle());
+
+   //About 1000 rad/s bandwidth
+   controllerD.SetGains(22, 4369, 0);
+   controllerQ.SetGains(22, 4369, 0);
+   controllerD.SetCallingFrequency(FREQUENCY);
+   controllerQ.SetCallingFrequency(FREQUENCY);
+   controllerD.SetMinMaxY(-30000, 30000);
+   controllerQ.SetMinMaxY(-30000, 30000);
+   controllerD.SetRef(0);
+   controllerQ.SetRef(FP_FROMINT(50));
+
+   for (int i = 0; i < FREQUENCY; i++)
+   {
+      s32fp il1 = motor.GetIl1();
+      s32fp il2 = motor.GetIl2();
+      uint16_t truth = motor.GetAngle();
+      //Voltage of the last period was applied at the last angle
+      uint16_t estimate = observer.Update(il1, il2, ud, uq, lastAngle, udc);
+      uint16_t angle = i > FREQUENCY / 10 ? estimate : truth;
+
+      foc.ParkClarke(il1, il2, angle);
+      ud = controllerD.Run(foc.id);
+      uq = controllerQ.Run(foc.iq);
+      foc.InvParkClarke(ud, uq, angle);
+      lastAngle = angle;
+
+      if (i > FREQUENCY / 2)
+      {
+         int err = (int16_t)(estimate - truth);
+         maxErr = MAX(maxErr, abs(err));
+         sumErr += err;
+         samples++;
+         maxIqErr = MAX(maxIqErr, fabsf(motor.GetIq() - 50));
+      }
+
+      motor.Step(foc.DutyCycles, udc);
+   }
+
+   Result result = { maxErr * 360.0f / 65536, sumErr * 360.0f / 65536 / samples, maxIqErr };
+   return result;
+}
+
+static void AngleErrorAcrossSpeedRange()
+{
+   const int frequencies[] = { 10, 25, 50, 100, 200, 300, 400 };
+
+   TestLog("   Hz  max err  mean err  iq err\n");
+
+   for (int frequency: frequencies)
+   {
+      Result result = Simulate(frequency, 0.02f);
+
+      TestLog("%5d %7.2f° %8.2f° %5.2f A\n", frequency, result.maxAngleErr, result.meanAngleErr, result.maxIqErr);
+      //The estimate lags by about 0.5° per 100 Hz
+      CHECK(result.maxAngleErr < 3);
+      CHECK(result.maxIqErr < 1);
+   }
+}
+
+static void ToleratesResistanceErrorAtSpeed()
+{
+   //Motor resistance 30% above the observer value, the error of u - R * i
+   //only matters where the back EMF is small
+   Result slow = Simulate(10, 0.026f);
+   Result fast = Simulate(100, 0.026f);
+
+   TestLog("R +30%%: %.2f° at 10 Hz, %.2f° at 100 Hz\n", slow.maxAngleErr, fast.maxAngleErr);
+   CHECK(slow.maxAngleErr > 10);
+   CHECK(fast.maxAngleErr < 1);
+   CHECK(fast.maxIqErr < 1);
+}
+
+int main()
+{
+   RUN_TEST(AngleErrorAcrossSpeedRange);
+   RUN_TEST(ToleratesResistanceErrorAtSpeed);
+   return TestResult();
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fu.h"
+#include "test.h"
+
+static void PercentageMatchesDivision()
+{
+   int maxDeviation = 0;
+
+   MotorVoltage::SetMaxAmp(37813);
+   MotorVoltage::SetBoost(1700);
+   MotorVoltage::SetWeakeningFrq(FP_FROMINT(67));
+
+   //Below the weakening frequency the curve is not limited, so GetAmp() is the raw curve
+   for (u32fp perc = 0; perc <= FP_FROMINT(100); perc += FP_FROMFLT(0.5))
+   {
+      for (u32fp frq = FP_FROMFLT(0.2); frq < FP_FROMINT(67); frq += FP_FROMFLT(0.3))
+      {
+         int expected = FP_MUL((int32_t)perc, (int32_t)MotorVoltage::GetAmp(frq)) / 100;
+         int deviation = expected - (int)MotorVoltage::GetAmpPerc(frq, perc);
+
+         CHECK(deviation >= 0);
+         maxDeviation = deviation > maxDeviation ? deviation : maxDeviation;
+      }
+   }
+   CHECK(maxDeviation <= 1);
+}
+
+static void LimitsStillApply()
+{
+   CHECK_EQUAL(0, MotorVoltage::GetAmpPerc(FP_FROMFLT(0.1), FP_FROMINT(100)));
+   CHECK_EQUAL(37813, MotorVoltage::GetAmpPerc(FP_FROMINT(200), FP_FROMINT(100)));
+   CHECK_EQUAL(37813 / 2, MotorVoltage::GetAmpPerc(FP_FROMINT(67), FP_FROMINT(50)));
+}
+
+static void CurveIndependentOfCallOrder()
+{
+   const u32fp frq[] = { FP_FROMINT(0), FP_FROMINT(10), FP_FROMINT(20), FP_FROMINT(40), FP_FROMINT(80) };
+   const uint32_t amp[] = { 1000, 5000, 6000, 20000, 30000 };
+   const u32fp probes[] = { FP_FROMINT(70), FP_FROMINT(5), FP_FROMINT(30), FP_FROMINT(15), FP_FROMINT(90), FP_FROMINT(20) };
+   const uint32_t expected[] = { 27500, 3000, 13000, 5500, 32500, 6000 };
+
+   MotorVoltage::SetMaxAmp(37813);
+   MotorVoltage::SetCurve(frq, amp, 5);
+
+   //Jump back and forth across segments like an ISR and the main loop would
+   for (int i = 0; i < 6; i++)
+   {
+      CHECK_EQUAL(expected[i], MotorVoltage::GetAmp(probes[i]));
+      int half = expected[i] / 2 - (int)MotorVoltage::GetAmpPerc(probes[i], FP_FROMINT(50));
+      int full = expected[i] - (int)MotorVoltage::GetAmpPerc(probes[i], FP_FROMINT(100));
+
+      CHECK(half >= 0 && half <= 1);
+      CHECK(full >= 0 && full <= 1);
+   }
+
+   MotorVoltage::SetCurve(0, 0, 0);
+}
+
+int main()
+{
+   RUN_TEST(PercentageMatchesDivision);
+   RUN_TEST(LimitsStillApply);
+   RUN_TEST(CurveIndependentOfCallOrder);
+
+   return TestResult();
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gainscheduler.h"
+#include "hal_system.h"
+#include "test.h"
+
+static void InterpolatesAndClamps()
+{
+   GainScheduler scheduler(Param::gsx0, 2);
+   int kp, ki;
+
+   scheduler.GetGains(FP_FROMINT(55), 0, kp, ki);
+   CHECK_EQUAL(200, kp);
+   CHECK_EQUAL(1500, ki);
+
+   scheduler.GetGains(FP_FROMINT(0), 0, kp, ki);
+   CHECK_EQUAL(100, kp);
+   scheduler.GetGains(FP_FROMINT(500), 0, kp, ki);
+   CHECK_EQUAL(300, kp);
+}
+
+static void SingleBreakpointIsRaisedToTwo()
+{
+   GainScheduler scheduler(Param::gsx0, 1);
+   int kp, ki;
+
+   //Raised to two breakpoints, so the end of the segment is reached
+   scheduler.GetGains(FP_FROMINT(100), 0, kp, ki);
+   CHECK_EQUAL(300, kp);
+   CHECK_EQUAL(2000, ki);
+}
+
+static void ApplyRestoresInterruptMask()
+{
+   GainScheduler scheduler(Param::gsx0, 2);
+   PiController ctrl;
+
+   scheduler.Apply(ctrl, FP_FROMINT(10));
+   CHECK(!hal_system_host_irq_disabled());
+
+   hal_irq_disable();
+   scheduler.Apply(ctrl, FP_FROMINT(10));
+   CHECK(hal_system_host_irq_disabled());
+   hal_irq_enable();
+
+   ctrl.SetCallingFrequency(1);
+   ctrl.SetMinMaxY(-100000, 100000);
+   ctrl.SetRef(FP_FROMINT(1));
+   //err * kp + err * ki with kp = 100, ki = 1000
+   CHECK_EQUAL(1100, ctrl.Run(0));
+}
+
+int main()
+{
+   Param::LoadDefaults();
+
+   RUN_TEST(InterpolatesAndClamps);
+   RUN_TEST(SingleBreakpointIsRaisedToTwo);
+   RUN_TEST(ApplyRestoresInterruptMask);
+
+   return TestResult();
+}
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "params.h"
+#include "hal_system.h"
+#include "test.h"
+
+static void IntegerKindsKeepFullRange()
+{
+   Param::SetInt(Param::uptime, 100000000);
+   CHECK_EQUAL(100000000, Param::GetInt(Param::uptime));
+   CHECK_EQUAL(100000000, Param::GetRaw(Param::uptime));
+
+   Param::SetInt(Param::uptime, -100000000);
+   CHECK_EQUAL(-100000000, Param::GetInt(Param::uptime));
+}
+
+static void GetSaturatesIntegerKinds()
+{
+   Param::SetInt(Param::uptime, 1000);
+   CHECK_EQUAL(FP_FROMINT(1000), Param::Get(Param::uptime));
+
+   //2^26 and beyond do not fit in fixed point
+   Param::SetInt(Param::uptime, 1 << 26);
+   CHECK_EQUAL(FP_FROMINT((1 << 26) - 1), Param::Get(Param::uptime));
+   Param::SetInt(Param::uptime, -100000000);
+   CHECK_EQUAL(FP_FROMINT(-(1 << 26)), Param::Get(Param::uptime));
+}
+
+static void KindsFollowTheList()
+{
+   CHECK_EQUAL(Param::KIND_FIXED, Param::GetKind(Param::boost));
+   CHECK_EQUAL(Param::KIND_INT, Param::GetKind(Param::canperiod));
+   CHECK_EQUAL(Param::KIND_ENUM, Param::GetKind(Param::pwmfrq));
+   CHECK_EQUAL(Param::KIND_BITFIELD, Param::GetKind(Param::dismask));
+   CHECK_EQUAL(Param::KIND_FIXED, Param::GetKind(Param::opmode));
+}
+
+static_assert(Param::KindOf(Param::canperiod) == Param::KIND_INT, "Kind must be a constant expression");
+
+static void TypedAccessorsMatchGeneric()
+{
+   CHECK_EQUAL(0, Param::Set<Param::boost>(FP_FROMFLT(1.5)));
+   CHECK_EQUAL(FP_FROMFLT(1.5), Param::Get(Param::boost));
+   CHECK_EQUAL(Param::GetInt(Param::boost), Param::GetInt<Param::boost>());
+   CHECK_EQUAL(-1, Param::Set<Param::polepairs>(FP_FROMINT(17)));
+
+   CHECK_EQUAL(0, Param::SetIntChecked<Param::canperiod>(999999));
+   CHECK_EQUAL(999999, Param::GetInt<Param::canperiod>());
+   CHECK_EQUAL(FP_FROMINT(999999), Param::Get<Param::canperiod>());
+   CHECK_EQUAL(-1, Param::SetIntChecked<Param::canperiod>(0));
+   CHECK_EQUAL(0, Param::Set<Param::pwmfrq>(FP_FROMINT(3)));
+   CHECK_EQUAL(3, Param::GetInt(Param::pwmfrq));
+
+   Param::SetInt<Param::uptime>(1 << 26);
+   CHECK_EQUAL(Param::Get(Param::uptime), Param::Get<Param::uptime>());
+   Param::SetFlt<Param::uptime>(FP_FROMINT(-5));
+   CHECK_EQUAL(-5, Param::GetRaw(Param::uptime));
+   Param::SetInt<Param::opmode>(1);
+   CHECK(Param::GetBool<Param::opmode>());
+   Param::LoadDefaults();
+}
+
+static void HistoryRecordsChanges()
+{
+   Param::HistoryEntry entry;
+
+   Param::ClearHistory();
+   Param::SetHistoryTime(42);
+   Param::Set(Param::fweak, FP_FROMINT(100), Param::SRC_SDO);
+   Param::SetInt(Param::fweak, 100); //unchanged, not recorded
+   Param::SetInt(Param::opmode, 1);  //display value, not recorded
+
+   CHECK(Param::GetHistory(0, entry));
+   CHECK_EQUAL(Param::fweak, entry.param);
+   CHECK_EQUAL(FP_FROMINT(67), entry.oldVal);
+   CHECK_EQUAL(FP_FROMINT(100), entry.newVal);
+   CHECK_EQUAL(42, entry.time);
+   CHECK_EQUAL(Param::SRC_SDO, entry.source);
+   CHECK(!Param::GetHistory(1, entry));
+}
+
+static void HistoryRecordsCheckedWritesOnly()
+{
+   Param::HistoryEntry entry;
+
+   Param::ClearHistory();
+   Param::SetInt(Param::fweak, 90);
+   Param::SetFlt(Param::polepairs, FP_FROMINT(4));
+   CHECK(!Param::GetHistory(0, entry));
+
+   Param::SetIntChecked(Param::canperiod, 50, Param::SRC_CAN);
+   Param::SetIntChecked(Param::canperiod, 50, Param::SRC_TERMINAL); //unchanged
+   CHECK(Param::GetHistory(0, entry));
+   CHECK_EQUAL(Param::canperiod, entry.param);
+   CHECK_EQUAL(Param::SRC_CAN, entry.source);
+   CHECK_EQUAL(50, entry.newVal);
+   CHECK(!Param::GetHistory(1, entry));
+   Param::LoadDefaults();
+}
+
+static void HistoryRestoresInterruptMask()
+{
+   Param::HistoryEntry entry;
+
+   Param::Set(Param::fweak, FP_FROMINT(110), Param::SRC_TERMINAL);
+   CHECK(Param::GetHistory(0, entry));
+   Param::ClearHistory();
+   CHECK(!hal_system_host_irq_disabled());
+
+   hal_irq_disable();
+   Param::SetIntChecked(Param::fweak, 120, Param::SRC_TERMINAL);
+   CHECK(Param::GetHistory(0, entry));
+   Param::ClearHistory();
+   CHECK(hal_system_host_irq_disabled());
+   hal_irq_enable();
+}
+
+int main()
+{
+   Param::LoadDefaults();
+
+   RUN_TEST(IntegerKindsKeepFullRange);
+   RUN_TEST(GetSaturatesIntegerKinds);
+   RUN_TEST(KindsFollowTheList);
+   RUN_TEST(TypedAccessorsMatchGeneric);
+   RUN_TEST(HistoryRecordsChanges);
+   RUN_TEST(HistoryRecordsCheckedWritesOnly);
+   RUN_TEST(HistoryRestoresInterruptMask);
+   return TestResult();
+}
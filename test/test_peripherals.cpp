@@ -0,0 +1,111 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+#include "digio.h"
+#include "anain.h"
+#include "stm32scheduler.h"
+#include "hal_adc.h"
+#include "hal_flash.h"
+#include "test.h"
+
+static int taskRuns[2];
+static void Task10ms() { taskRuns[0]++; }
+static void Task100ms() { taskRuns[1]++; }
+
+static void DigitalIo()
+{
+   DIG_IO_CONFIGURE(DIG_IO_LIST);
+
+   CHECK_EQUAL(GPIO_MODE_INPUT | GPIO_CNF_INPUT_PULL_UPDOWN << 2, hal_gpio_host_get_mode(GPIOB, 6));
+   CHECK_EQUAL(GPIO_MODE_OUTPUT_50_MHZ | GPIO_CNF_OUTPUT_PUSHPULL << 2, hal_gpio_host_get_mode(GPIOC, 13));
+
+   hal_gpio_host_set_input(GPIOB, GPIO6, true);
+   CHECK(DigIo::start_in.Get());
+   hal_gpio_host_set_input(GPIOB, GPIO6, false);
+   CHECK(!DigIo::start_in.Get());
+
+   DigIo::led_out.Set();
+   CHECK_EQUAL(GPIO13, hal_gpio_host_get_output(GPIOC));
+   DigIo::led_out.Toggle();
+   CHECK_EQUAL(0, hal_gpio_host_get_output(GPIOC));
+}
+
+static void AnalogInputsAverageMedians()
+{
+   ANA_IN_CONFIGURE(ANA_IN_LIST);
+   AnaIn::Start();
+
+   //PC1 is ADC channel 11, PC3 channel 13
+   hal_adc_host_set(11, 1000);
+   hal_adc_host_set(13, 3000);
+   hal_adc_host_convert(NUM_SAMPLES);
+   CHECK_EQUAL(1000, AnaIn::throttle1.Get());
+   CHECK_EQUAL(3000, AnaIn::udc.Get());
+
+   //A single outlier is removed by the median filter
+   hal_adc_host_set(11, 4095);
+   hal_adc_host_convert(1);
+   CHECK_EQUAL(1000, AnaIn::throttle1.Get());
+}
+
+static void SchedulerRunsTasksAtTheirPeriod()
+{
+   Stm32Scheduler scheduler(TIM2);
+
+   scheduler.AddTask(Task10ms, 10);
+   scheduler.AddTask(Task100ms, 100);
+
+   //Timer counts at 100 kHz, simulate 1 s in 10 µs steps calling the ISR
+   for (int i = 0; i < 100000; i++)
+   {
+      hal_timer_host_tick(TIM2, 1);
+      scheduler.Run();
+   }
+
+   CHECK_NEAR(100, taskRuns[0], 1);
+   CHECK_NEAR(10, taskRuns[1], 1);
+   CHECK(scheduler.GetCpuLoad() >= 0);
+}
+
+static void FlashOverrunIsCaught()
+{
+   pid_t pid = fork();
+
+   if (pid == 0)
+   {
+      hal_flash_unlock();
+      hal_flash_program_word(HOST_FLASH_BASE + HOST_FLASH_SIZE, 0);
+      _exit(0);
+   }
+
+   int status = 0;
+   waitpid(pid, &status, 0);
+   CHECK(WIFSIGNALED(status));
+}
+
+int main()
+{
+   RUN_TEST(DigitalIo);
+   RUN_TEST(AnalogInputsAverageMedians);
+   RUN_TEST(SchedulerRunsTasksAtTheirPeriod);
+   RUN_TEST(FlashOverrunIsCaught);
+
+   return TestResult();
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "piautotune.h"
+#include "picontroller.h"
+#include "my_math.h"
+#include "test.h"
+
+#define FREQUENCY 8800
+
+/** RL load fed by a half bridge, actuator digits ±32767 map to ±udc/2.
+ * The output reaches the plant two calls late like with PWM update and
+ * current sampling on an inverter */
+struct RlPlant
+{
+   double r, l, udc, i;
+   int32_t delayed[2];
+
+   RlPlant(double r, double l, double udc) : r(r), l(l), udc(udc), i(0) { delayed[0] = delayed[1] = 0; }
+
+   s32fp Step(int32_t u)
+   {
+      double voltage = delayed[1] * udc / 65536;
+
+      delayed[1] = delayed[0];
+      delayed[0] = u;
+      i += (voltage - r * i) / (l * FREQUENCY);
+      return FP_FROMFLT(i);
+   }
+};
+
+static PiAutotune rlTune(Param::curkp, Param::curki);
+
+static void TunesRlPlant()
+{
+   RlPlant plant(0.05, 1e-3, 300);
+   s32fp current = 0;
+
+   rlTune.Start(FP_FROMINT(20), 0, 2000, FP_FROMFLT(0.5), FREQUENCY, 5);
+
+   for (int i = 0; i < FREQUENCY && rlTune.GetState() == PiAutotune::RUNNING; i++)
+      current = plant.Step(rlTune.Run(current));
+
+   CHECK_EQUAL(PiAutotune::DONE, rlTune.GetState());
+   CHECK_EQUAL(rlTune.GetKp(), Param::GetInt(Param::curkp));
+   CHECK_EQUAL(rlTune.GetKi(), Param::GetInt(Param::curki));
+   //Ultimate gain and period of the RL load with two calls of dead time,
+   //ki = 329000 at 8800 Hz is scaled down to about 9 Hz
+   CHECK_NEAR(374, rlTune.GetKp(), 20);
+   CHECK_NEAR(9, rlTune.GetFrequency(), 1);
+   CHECK_NEAR(329000 * rlTune.GetFrequency() / FREQUENCY, rlTune.GetKi(), 20);
+   CHECK(rlTune.GetKi() <= rlTune.GetKp());
+}
+
+static void TunedLoopSettles()
+{
+   RlPlant plant(0.05, 1e-3, 300);
+   PiController pi;
+   s32fp current = 0, peak = 0, min = FP_FROMINT(100), max = 0;
+
+   pi.SetGains(Param::GetInt(Param::curkp), Param::GetInt(Param::curki));
+   pi.SetCallingFrequency(rlTune.GetFrequency());
+   pi.SetMinMaxY(-32767, 32767);
+   pi.SetRef(FP_FROMINT(20));
+
+   for (int i = 0; i < FREQUENCY / 20; i++)
+   {
+      current = plant.Step(pi.Run(current));
+      peak = MAX(peak, current);
+
+      if (i >= FREQUENCY / 40)
+      {
+         min = MIN(min, current);
+         max = MAX(max, current);
+      }
+   }
+
+   TestLog("peak %.2f A, settled %.2f..%.2f A\n", (double)peak / FRAC_FAC, (double)min / FRAC_FAC, (double)max / FRAC_FAC);
+   //Ziegler-Nichols gains typically overshoot by 40 to 50 %
+   CHECK(peak < FP_FROMINT(30));
+   CHECK_NEAR(FP_FROMINT(20), current, FP_FROMFLT(0.1));
+   CHECK(max - min < FP_FROMFLT(0.2));
+}
+
+static void FailsWithoutOscillation()
+{
+   RlPlant plant(0.05, 1e-3, 0); //no DC link voltage
+   PiAutotune tune(Param::curkp, Param::curki);
+   s32fp current = 0;
+   int calls = 0;
+
+   tune.Start(FP_FROMINT(20), 0, 2000, FP_FROMFLT(0.5), FREQUENCY, 5);
+
+   for (; calls < 10 * FREQUENCY && tune.GetState() == PiAutotune::RUNNING; calls++)
+      current = plant.Step(tune.Run(current));
+
+   CHECK_EQUAL(PiAutotune::FAILED, tune.GetState());
+   CHECK_NEAR(5 * FREQUENCY, calls, 2);
+}
+
+int main()
+{
+   RUN_TEST(TunesRlPlant);
+   RUN_TEST(TunedLoopSettles);
+   RUN_TEST(FailsWithoutOscillation);
+   return TestResult();
+}
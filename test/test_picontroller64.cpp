@@ -0,0 +1,145 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "picontroller.h"
+#include "picontroller64.h"
+#include "test.h"
+
+/* PiController64 must produce exactly the output of PiController for all
+ * inputs where PiController does not overflow */
+
+static uint32_t seed = 1;
+
+static int32_t Random(int32_t range)
+{
+   seed = seed * 1664525 + 1013904223;
+   return (int32_t)((seed >> 8) % (2 * range + 1)) - range;
+}
+
+static const int gains[][2] =
+{
+   { 10, 100 }, { 300, 5000 }, { 50, 20000 }, { 1000, 30000 }, { 1, 0 }, { -50, -2000 }
+};
+static const int frequencies[] = { 1, 7, 1024, 8800, 10000, 17000 };
+/* Without saturation the error sum of a random walk grows so large that
+ * (esum / frequency) * ki overflows in PiController at low frequencies */
+static const int openLoopFrequencies[] = { 1024, 8800, 10000, 17000 };
+
+/** Run both controllers with random measurements
+ * @return number of steps with differing output */
+static int Compare(int kp, int ki, int frequency, int32_t minY, int32_t maxY, bool closedLoop)
+{
+   PiController ref;
+   PiController64 dut;
+   int differences = 0;
+   int32_t plant = 0;
+
+   ref.SetCallingFrequency(frequency);
+   dut.SetCallingFrequency(frequency);
+   ref.SetGains(kp, ki);
+   dut.SetGains(kp, ki);
+   ref.SetMinMaxY(minY, maxY);
+   dut.SetMinMaxY(minY, maxY);
+   ref.SetRef(FP_FROMINT(20));
+   dut.SetRef(FP_FROMINT(20));
+
+   for (int i = 0; i < 20000; i++)
+   {
+      s32fp measured = closedLoop ? FP_FROMINT(plant) / 100 + Random(32) : FP_FROMINT(20) + Random(3200);
+      int32_t yRef = ref.Run(measured);
+      int32_t yDut = dut.Run(measured);
+
+      if (yRef != yDut)
+         differences++;
+      plant += (yRef - plant) / 16;
+   }
+   return differences;
+}
+
+static void OpenLoopIsBitExact()
+{
+   for (unsigned g = 0; g < sizeof(gains) / sizeof(gains[0]); g++)
+   {
+      for (unsigned f = 0; f < sizeof(openLoopFrequencies) / sizeof(openLoopFrequencies[0]); f++)
+      {
+         int kp = gains[g][0], ki = gains[g][1], frequency = openLoopFrequencies[f];
+
+         if (!CHECK_EQUAL(0, Compare(kp, ki, frequency, -1000000000, 1000000000, false)))
+            TestLog("kp=%d ki=%d frequency=%d\n", kp, ki, frequency);
+      }
+   }
+}
+
+static void SaturatedClosedLoopIsBitExact()
+{
+   for (unsigned g = 0; g < sizeof(gains) / sizeof(gains[0]); g++)
+   {
+      for (unsigned f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); f++)
+      {
+         int kp = gains[g][0], ki = gains[g][1], frequency = frequencies[f];
+
+         if (!CHECK_EQUAL(0, Compare(kp, ki, frequency, -1500, 1500, true)))
+            TestLog("kp=%d ki=%d frequency=%d\n", kp, ki, frequency);
+      }
+   }
+}
+
+static void PreloadIsBitExact()
+{
+   PiController ref;
+   PiController64 dut;
+
+   ref.SetCallingFrequency(8800);
+   dut.SetCallingFrequency(8800);
+   ref.SetGains(300, 5000);
+   dut.SetGains(300, 5000);
+   ref.SetMinMaxY(-30000, 30000);
+   dut.SetMinMaxY(-30000, 30000);
+   ref.PreloadIntegrator(12345);
+   dut.PreloadIntegrator(12345);
+
+   CHECK_EQUAL(ref.Run(0), dut.Run(0));
+   CHECK_EQUAL(ref.Run(FP_FROMINT(3)), dut.Run(FP_FROMINT(3)));
+}
+
+static void ErrorSumSaturates()
+{
+   PiController64 dut;
+
+   dut.SetCallingFrequency(1);
+   dut.SetGains(0, 1);
+   dut.SetMinMaxY(-2000000000, 2000000000);
+   dut.SetRef(FP_FROMINT(1000000));
+
+   int32_t y = 0;
+   for (int i = 0; i < 100; i++)
+      y = dut.Run(0);
+
+   //Error sum stops at 2^31 - 1 instead of wrapping to negative
+   CHECK_EQUAL(0x7FFFFFFF >> CST_DIGITS, y);
+}
+
+int main()
+{
+   RUN_TEST(OpenLoopIsBitExact);
+   RUN_TEST(SaturatedClosedLoopIsBitExact);
+   RUN_TEST(PreloadIsBitExact);
+   RUN_TEST(ErrorSumSaturates);
+
+   return TestResult();
+}
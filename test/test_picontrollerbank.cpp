@@ -0,0 +1,119 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdlib.h>
+#include "picontrollerbank.h"
+#include "my_math.h"
+#include "test.h"
+
+#define FREQUENCY 8800
+
+static void Setup(PiControllerBank<4>& bank, PiControllerBank<1>* single)
+{
+   bank.SetCallingFrequency(FREQUENCY);
+
+   for (int i = 0; i < 4; i++)
+   {
+      single[i].SetCallingFrequency(FREQUENCY);
+      bank.SetGains(i, 10 + i, 3000 * i);
+      single[i].SetGains(0, 10 + i, 3000 * i);
+      bank.SetMinMaxY(i, -1000, 1000);
+      single[i].SetMinMaxY(0, -1000, 1000);
+      bank.SetRef(i, FP_FROMINT(20 * i));
+      single[i].SetRef(0, FP_FROMINT(20 * i));
+   }
+}
+
+static void ChannelsAreIndependent()
+{
+   PiControllerBank<4> bank;
+   PiControllerBank<1> single[4];
+
+   Setup(bank, single);
+   srand(1);
+
+   for (int k = 0; k < 10000; k++)
+   {
+      s32fp cur[4];
+      int32_t y[4], ySingle;
+
+      for (int i = 0; i < 4; i++)
+         cur[i] = (rand() % 6400) - 1000;
+
+      bank.Run(cur, y);
+
+      for (int i = 0; i < 4; i++)
+      {
+         single[i].Run(&cur[i], &ySingle);
+         if (!CHECK_EQUAL(ySingle, y[i])) return;
+      }
+   }
+}
+
+static void MatchesIdealPi()
+{
+   PiControllerBank<1> bank;
+   s32fp cur = FP_FROMINT(5);
+   double integral = 0;
+   int32_t y;
+
+   bank.SetCallingFrequency(FREQUENCY);
+   bank.SetGains(0, 20, 3000);
+   bank.SetMinMaxY(0, -1000, 1000);
+   bank.SetRef(0, FP_FROMINT(10));
+
+   //Error 5 gives 100 proportional, the integral reaches the limit after about 0.5 s.
+   //The output is truncated, so it is up to one digit below the ideal value
+   for (int i = 0; i < FREQUENCY / 2; i++)
+   {
+      integral += 5.0 * 3000 / FREQUENCY;
+      bank.Run(&cur, &y);
+      if (!CHECK_NEAR(MIN(100 + integral, 1000) - 0.5, y, 0.6)) return;
+   }
+}
+
+static void RecoversFromSaturation()
+{
+   PiControllerBank<1> bank;
+   s32fp cur = 0;
+   int32_t y;
+
+   bank.SetCallingFrequency(FREQUENCY);
+   bank.SetGains(0, 20, 3000);
+   bank.SetMinMaxY(0, -1000, 1000);
+   bank.SetRef(0, FP_FROMINT(10));
+
+   //Saturate for a long time, anti windup keeps the integrator at the limit
+   for (int i = 0; i < 10 * FREQUENCY; i++)
+      bank.Run(&cur, &y);
+
+   CHECK_EQUAL(1000, y);
+
+   //Reverse the error, output must leave the limit immediately
+   cur = FP_FROMINT(20);
+   bank.Run(&cur, &y);
+   CHECK(y < 1000 - 150);
+}
+
+int main()
+{
+   RUN_TEST(ChannelsAreIndependent);
+   RUN_TEST(MatchesIdealPi);
+   RUN_TEST(RecoversFromSaturation);
+   return TestResult();
+}
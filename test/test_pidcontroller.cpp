@@ -0,0 +1,121 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pidcontroller.h"
+#include "test.h"
+
+static void ProportionalUsesSetpointWeight()
+{
+   PidController<false, false, false> p;
+
+   p.SetGains(3, 0, 0);
+   p.SetMinMaxY(-1000, 1000);
+   p.SetRef(FP_FROMINT(10));
+   CHECK_EQUAL(30, p.Run(0));
+
+   //Half weight: 3 * (0.5 * 10 - 2)
+   p.SetSetpointWeight(FP_FROMFLT(0.5));
+   CHECK_EQUAL(9, p.Run(FP_FROMINT(2)));
+}
+
+static void IntegralReachesOutputAfterOneSecond()
+{
+   PidController<true, false, false> pi;
+   int32_t y = 0;
+
+   pi.SetGains(0, 20, 0);
+   pi.SetCallingFrequency(100);
+   pi.SetMinMaxY(-1000, 1000);
+   pi.SetRef(FP_FROMINT(10));
+
+   //ki * err * t = 20 * 10 * 1s
+   for (int i = 0; i < 100; i++)
+      y = pi.Run(0);
+
+   CHECK_NEAR(200, y, 1);
+}
+
+static void ClampingStopsIntegration()
+{
+   PidController<true, false, false> pi;
+
+   pi.SetGains(1, 100, 0);
+   pi.SetCallingFrequency(100);
+   pi.SetMinMaxY(-50, 50);
+   pi.SetRef(FP_FROMINT(10));
+
+   for (int i = 0; i < 1000; i++)
+      CHECK(pi.Run(0) <= 50);
+
+   //Without wind up the output leaves the limit as soon as the error reverses
+   CHECK(pi.Run(FP_FROMINT(100)) < 50);
+}
+
+static void DerivativeIgnoresSetpointSteps()
+{
+   PidController<false, true, false> pd;
+
+   pd.SetGains(0, 0, 1);
+   pd.SetCallingFrequency(100);
+   pd.SetMinMaxY(-1000, 1000);
+
+   pd.Run(0);
+   pd.SetRef(FP_FROMINT(100));
+   CHECK_EQUAL(0, pd.Run(0));
+
+   //kd * frequency * -dx = 1 * 100 * -1
+   CHECK_EQUAL(-100, pd.Run(FP_FROMINT(1)));
+}
+
+static void DerivativeFilterSmoothsSteps()
+{
+   PidController<false, true, false> pd;
+
+   pd.SetGains(0, 0, 1);
+   pd.SetCallingFrequency(100);
+   pd.SetDerivativeFilter(2);
+   pd.SetMinMaxY(-1000, 1000);
+
+   pd.Run(0);
+   //A quarter of the unfiltered -100 at the first step, then decaying
+   CHECK_EQUAL(-25, pd.Run(FP_FROMINT(1)));
+   CHECK_NEAR(-19, pd.Run(FP_FROMINT(1)), 1);
+}
+
+static void FeedForwardAddsToOutput()
+{
+   PidController<false, false, true> pff;
+
+   pff.SetGains(2, 0, 0);
+   pff.SetFeedForwardGain(3);
+   pff.SetMinMaxY(-1000, 1000);
+   pff.SetRef(FP_FROMINT(10));
+   pff.SetFeedForward(FP_FROMINT(7));
+   CHECK_EQUAL(2 * 10 + 3 * 7, pff.Run(0));
+}
+
+int main()
+{
+   RUN_TEST(ProportionalUsesSetpointWeight);
+   RUN_TEST(IntegralReachesOutputAfterOneSecond);
+   RUN_TEST(ClampingStopsIntegration);
+   RUN_TEST(DerivativeIgnoresSetpointSteps);
+   RUN_TEST(DerivativeFilterSmoothsSteps);
+   RUN_TEST(FeedForwardAddsToOutput);
+   return TestResult();
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sine_core.h"
+#include "foc.h"
+#include "test.h"
+
+/* The discontinuous modes must clamp the same window relative to the phase
+ * voltage, no matter whether SineChannel or FocChannel generates it */
+
+#define DUTY_MAX     65536
+#define ANGLE_STEP   16
+#define DEGREES(a)   ((a) * 360.0 / 65536)
+
+/** Centre of the interval in which phase 1 is clamped to the positive rail
+ * @param peak angle at which the phase 1 voltage peaks
+ * @return centre relative to the peak in degrees, positive is after the peak */
+template<typename T>
+static double ClampCentre(T& channel, void (*calc)(T&, uint16_t), uint16_t peak)
+{
+   double sum = 0;
+   int count = 0;
+
+   for (int angle = 0; angle < 65536; angle += ANGLE_STEP)
+   {
+      calc(channel, angle);
+
+      if ((uint32_t)channel.DutyCycles[0] == DUTY_MAX)
+      {
+         sum += (int16_t)(angle - peak);
+         count++;
+      }
+   }
+   return count > 0 ? DEGREES(sum / count) : 1000;
+}
+
+static void CalcSine(SineChannel& channel, uint16_t angle)
+{
+   channel.Calc(angle);
+}
+
+static void CalcFoc(FocChannel& channel, uint16_t angle)
+{
+   //Voltage purely on the d axis, so phase 1 is cos(angle)
+   channel.InvParkClarke(28000, 0, angle);
+}
+
+static void CheckWindow(PwmMode::PwmMode mode, double expectedCentre)
+{
+   SineChannel sine;
+   FocChannel foc;
+
+   sine.SetAmp(SineCore::MAXAMP * 9 / 10);
+   sine.SetPwmMode(mode);
+   foc.SetPwmMode(mode);
+
+   double sineCentre = ClampCentre(sine, CalcSine, 16384);
+   double focCentre = ClampCentre(foc, CalcFoc, 0);
+
+   CHECK_NEAR(expectedCentre, sineCentre, 2);
+   CHECK_NEAR(expectedCentre, focCentre, 2);
+   CHECK_NEAR(focCentre, sineCentre, 1);
+}
+
+static void Dpwm0ClampsAheadOfPeak()
+{
+   CheckWindow(PwmMode::DPWM0, -30);
+}
+
+static void Dpwm1ClampsAtPeak()
+{
+   CheckWindow(PwmMode::DPWM1, 0);
+}
+
+static void Dpwm2ClampsBehindPeak()
+{
+   CheckWindow(PwmMode::DPWM2, 30);
+}
+
+static void DeadTimeCompensationDoesNotWrap()
+{
+   SineChannel plain, compensated;
+
+   plain.SetAmp(SineCore::MAXAMP);
+   compensated.SetAmp(SineCore::MAXAMP);
+   compensated.SetDeadTimeCompensation(500, 100);
+   //Negative currents in phase 1 and 2 shorten their pulses by the full 500 digits
+   compensated.SetPhaseCurrents(-1000, -1000);
+
+   for (int angle = 0; angle < 65536; angle += ANGLE_STEP)
+   {
+      plain.Calc(angle);
+      compensated.Calc(angle);
+
+      for (int i = 0; i < 2; i++)
+      {
+         //Shortening a pulse can never make it longer
+         if (!CHECK(compensated.DutyCycles[i] <= plain.DutyCycles[i]))
+         {
+            TestLog("angle %d phase %d: %u -> %u\n", angle, i + 1, plain.DutyCycles[i], compensated.DutyCycles[i]);
+            return;
+         }
+      }
+   }
+}
+
+int main()
+{
+   RUN_TEST(Dpwm0ClampsAheadOfPeak);
+   RUN_TEST(Dpwm1ClampsAtPeak);
+   RUN_TEST(Dpwm2ClampsBehindPeak);
+   RUN_TEST(DeadTimeCompensationDoesNotWrap);
+
+   return TestResult();
+}
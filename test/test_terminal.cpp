@@ -0,0 +1,134 @@
+/*
+ * This file is part of the libopeninv project.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include "params.h"
+#include "terminal.h"
+#include "terminalcommands.h"
+#include "stm32_can.h"
+#include "hal_can.h"
+#include "hal_uart.h"
+#include "hal_gpio.h"
+#include "hal_system.h"
+#include "test.h"
+
+static const TERM_CMD commands[] =
+{
+   { "set", TerminalCommands::ParamSet },
+   { "get", TerminalCommands::ParamGet },
+   { "save", TerminalCommands::SaveParameters },
+   { "load", TerminalCommands::LoadParameters },
+   { "reset", TerminalCommands::Reset },
+   { NULL, NULL }
+};
+
+static Terminal* term;
+static char output[1024];
+
+/** Type a command line and return everything the terminal sent, including the echo */
+static const char* Command(const char* line)
+{
+   hal_uart_host_receive(USART3, line, strlen(line));
+   term->Run();
+   int len = hal_uart_host_transmitted(USART3, output, sizeof(output) - 1);
+   output[len] = 0;
+   return output;
+}
+
+static void GetParameter()
+{
+   CHECK(strstr(Command("get polepairs\n"), "get polepairs\n2.00\r\n") != 0);
+   CHECK(strstr(Command("get canperiod\n"), "\n100\r\n") != 0);
+   CHECK(strstr(Command("get nonsense\n"), "Unknown parameter: 'nonsense'") != 0);
+}
+
+static void SetParameter()
+{
+   CHECK(strstr(Command("set fweak 120\n"), "Set OK") != 0);
+   CHECK_EQUAL(120, Param::GetInt(Param::fweak));
+   CHECK(strstr(Command("set fweak 1000\n"), "Value out of range") != 0);
+   CHECK_EQUAL(120, Param::GetInt(Param::fweak));
+}
+
+static void SetBitfieldFullRange()
+{
+   CHECK(strstr(Command("set dismask 0xF0000001\n"), "Set OK") != 0);
+   CHECK_EQUAL(0xF0000001, (uint32_t)Param::GetRaw(Param::dismask));
+   CHECK(strstr(Command("set dismask 4026531842\n"), "Set OK") != 0);
+   CHECK_EQUAL(0xF0000002, (uint32_t)Param::GetRaw(Param::dismask));
+   CHECK(strstr(Command("get dismask\n"), "\n4026531842\r\n") != 0);
+}
+
+static void UnknownCommand()
+{
+   CHECK(strstr(Command("frobnicate\n"), "Unknown command sequence") != 0);
+}
+
+static void PartialLineIsEchoedOnly()
+{
+   CHECK(strcmp(Command("ge"), "ge") == 0);
+   CHECK(strstr(Command("t polepairs\r"), "t polepairs\r2.00") != 0);
+}
+
+static void SaveAndLoad()
+{
+   Command("set fweak 150\n");
+   CHECK(strstr(Command("save\n"), "CANMAP stored") != 0);
+   Command("set fweak 10\n");
+   CHECK(strstr(Command("load\n"), "Parameters loaded") != 0);
+   CHECK_EQUAL(150, Param::GetInt(Param::fweak));
+}
+
+static void NodeIdDisablesTerminal()
+{
+   term->SetNodeId(2);
+   hal_uart_host_transmitted(USART3, output, sizeof(output));
+   CHECK(strstr(Command("get fweak\n"), "150") == 0);
+   CHECK_EQUAL(GPIO_MODE_INPUT | GPIO_CNF_INPUT_FLOAT << 2, hal_gpio_host_get_mode(GPIOB, 10));
+   CHECK(strstr(Command("enableuart 2\n"), "OK") != 0);
+   CHECK(strstr(Command("get fweak\n"), "150") != 0);
+   CHECK_EQUAL(GPIO_MODE_OUTPUT_50_MHZ | GPIO_CNF_OUTPUT_ALTFN_PUSHPULL << 2, hal_gpio_host_get_mode(GPIOB, 10));
+}
+
+static void ResetCommand()
+{
+   int resets = hal_system_host_resets();
+
+   Command("reset\n");
+   CHECK_EQUAL(resets + 1, hal_system_host_resets());
+}
+
+int main()
+{
+   Can can(CAN1, Can::Baud500);
+   Terminal terminal(USART3, commands);
+
+   Param::LoadDefaults();
+   term = &terminal;
+
+   RUN_TEST(GetParameter);
+   RUN_TEST(SetParameter);
+   RUN_TEST(SetBitfieldFullRange);
+   RUN_TEST(UnknownCommand);
+   RUN_TEST(PartialLineIsEchoedOnly);
+   RUN_TEST(SaveAndLoad);
+   RUN_TEST(NodeIdDisablesTerminal);
+   RUN_TEST(ResetCommand);
+
+   return TestResult();
+}